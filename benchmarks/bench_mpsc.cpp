@@ -0,0 +1,63 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+#include "rt_alloc_guard.h"
+
+// Contenção entre produtores: N threads enviam itens para um único
+// consumidor. Reporta o custo médio por item visto pelo consumidor.
+static double runNsPerItem(int producers, size_t itemsPerProducer) {
+    static MPSCQueue<uint64_t, 4096> queue;
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (size_t i = 0; i < itemsPerProducer; ++i) {
+                uint64_t msg = (static_cast<uint64_t>(p) << 48) | i;
+                while (!queue.push(msg)) std::this_thread::yield();
+            }
+        });
+    }
+
+    const size_t total = itemsPerProducer * producers;
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+
+    uint64_t msg;
+    {
+        RtScope rt; // O consumidor faz o papel do thread de áudio
+        for (size_t received = 0; received < total;) {
+            if (queue.pop(msg)) ++received;
+            else std::this_thread::yield();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    for (auto& t : threads) t.join();
+    return std::chrono::duration<double, std::nano>(end - start).count() / total;
+}
+
+int main(int argc, char* argv[]) {
+    size_t itemsPerProducer = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    std::printf("%-10s %14s %16s\n", "Producers", "ns/item", "Mitems/s");
+    for (int producers : {1, 2, 4, 8, 16}) {
+        double ns = runNsPerItem(producers, itemsPerProducer);
+        std::printf("%-10d %14.2f %16.2f\n", producers, ns, 1e3 / ns);
+    }
+
+    RtAllocStats rt = rtAllocStats();
+    if (rt.allocations || rt.deallocations) {
+        std::printf("ERRO: %llu alocações / %llu liberações no consumidor\n",
+                    static_cast<unsigned long long>(rt.allocations),
+                    static_cast<unsigned long long>(rt.deallocations));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ring_buffer.h"
+#include "rt_alloc_guard.h"
+
+// Layout anterior: índices na mesma linha de cache, sem cópia local do
+// índice remoto. Mantido aqui apenas como referência de comparação.
+template<typename T, size_t Size>
+class PackedRingBuffer {
+    std::array<T, Size> buffer;
+    std::atomic<size_t> writePos{0};
+    std::atomic<size_t> readPos{0};
+
+public:
+    bool push(const T& item) {
+        size_t w = writePos.load(std::memory_order_relaxed);
+        size_t next = (w + 1) % Size;
+        if (next == readPos.load(std::memory_order_acquire)) return false;
+        buffer[w] = item;
+        writePos.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t r = readPos.load(std::memory_order_relaxed);
+        if (r == writePos.load(std::memory_order_acquire)) return false;
+        item = buffer[r];
+        readPos.store((r + 1) % Size, std::memory_order_release);
+        return true;
+    }
+};
+
+// Núcleos realmente disponíveis para o processo (respeita cgroups/taskset)
+static int usableCores() {
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) return CPU_COUNT(&set);
+#endif
+    return static_cast<int>(std::thread::hardware_concurrency());
+}
+
+static void pinToCore(int index) {
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    for (int cpu = 0, seen = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed)) continue;
+        if (seen++ == index) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            return;
+        }
+    }
+#else
+    (void)index;
+#endif
+}
+
+// Ping-pong entre dois núcleos: cada item faz ida e volta por dois rings.
+// O tempo por round-trip mede a latência de transferência entre núcleos.
+template<typename Ring>
+static double pingPongNs(size_t iterations) {
+    Ring ping, pong;
+
+    std::thread echo([&] {
+        pinToCore(1);
+        RtScope rt;
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t v;
+            while (!ping.pop(v)) {}
+            while (!pong.push(v)) {}
+        }
+    });
+
+    pinToCore(0);
+    RtScope rt;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        size_t v;
+        while (!ping.push(i)) {}
+        while (!pong.pop(v)) {}
+    }
+    auto end = std::chrono::steady_clock::now();
+    echo.join();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Vazão em fluxo contínuo: o produtor nunca espera resposta, então o custo
+// dominante é o tráfego de coerência sobre os índices.
+template<typename Ring>
+static double streamNsPerItem(size_t items) {
+    Ring ring;
+
+    std::thread consumer([&] {
+        pinToCore(1);
+        RtScope rt;
+        size_t v;
+        for (size_t i = 0; i < items; ++i) {
+            while (!ring.pop(v)) {}
+        }
+    });
+
+    pinToCore(0);
+    RtScope rt;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < items; ++i) {
+        while (!ring.push(i)) {}
+    }
+    consumer.join();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / items;
+}
+
+int main() {
+    if (usableCores() < 2) {
+        std::printf("Benchmark requer pelo menos 2 núcleos.\n");
+        return 1;
+    }
+
+    constexpr size_t kRoundTrips = 1'000'000;
+    constexpr size_t kStreamItems = 20'000'000;
+
+    using Packed = PackedRingBuffer<size_t, 1024>;
+    using Padded = LockFreeRingBuffer<size_t, 1024>;
+    using Masked = PowerOfTwoRingBuffer<size_t, 1024>;
+
+    double packedRtt = pingPongNs<Packed>(kRoundTrips);
+    double paddedRtt = pingPongNs<Padded>(kRoundTrips);
+    double packedStream = streamNsPerItem<Packed>(kStreamItems);
+    double paddedStream = streamNsPerItem<Padded>(kStreamItems);
+    double maskedRtt = pingPongNs<Masked>(kRoundTrips);
+    double maskedStream = streamNsPerItem<Masked>(kStreamItems);
+
+    std::printf("%-28s %12s %12s\n", "Layout", "RTT (ns)", "Stream (ns)");
+    std::printf("%-28s %12.1f %12.2f\n", "Packed (sem cache)", packedRtt, packedStream);
+    std::printf("%-28s %12.1f %12.2f\n", "Padded + cached indices", paddedRtt, paddedStream);
+    std::printf("%-28s %12.1f %12.2f\n", "Power-of-two + mask", maskedRtt, maskedStream);
+    std::printf("Speedup stream: %.2fx\n", packedStream / paddedStream);
+
+    // Os laços medidos rodam em RtScope: qualquer alocação invalida a medição
+    RtAllocStats rt = rtAllocStats();
+    if (rt.allocations || rt.deallocations) {
+        std::printf("ERRO: %llu alocações / %llu liberações nos laços de tempo real\n",
+                    static_cast<unsigned long long>(rt.allocations),
+                    static_cast<unsigned long long>(rt.deallocations));
+        return 1;
+    }
+    return 0;
+}
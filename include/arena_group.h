@@ -0,0 +1,183 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "memory_arena.h"
+
+// Conjunto de arenas por thread para renderização paralela. Uma única
+// reserva alinhada (com as mesmas ArenaOptions de uma MemoryArena: huge
+// pages, prefault, mlock) é dividida em sub-arenas, uma por worker, cada uma
+// começando em linha de cache própria. Cada worker aloca da sua sem nenhuma
+// sincronização; local() associa o thread atual a uma sub-arena na primeira
+// chamada, e a associação é desfeita quando o thread termina (threads novos
+// por job reutilizam as sub-arenas dos que já saíram).
+class ArenaGroup {
+    struct alignas(kArenaAlignment) Worker {
+        MemoryArena arena;
+
+        Worker(void* storage, size_t size) : arena(storage, size) {}
+    };
+
+    // Dono de cada sub-arena. Compartilhado com os threads associados, para
+    // que a liberação na saída do thread continue válida mesmo que o grupo
+    // já tenha sido destruído.
+    struct Owners {
+        explicit Owners(size_t count) : slots(count) {}
+
+        std::vector<std::atomic<std::thread::id>> slots;
+        std::atomic<bool> groupAlive{true};
+    };
+
+    // Posse de uma sub-arena pelo thread atual
+    struct Lease {
+        std::shared_ptr<Owners> owners;
+        size_t index;
+
+        void release(std::thread::id me) const {
+            owners->slots[index].compare_exchange_strong(me, std::thread::id{}, std::memory_order_release);
+        }
+    };
+
+    // Estado por thread: cache da última associação (o id distingue grupos
+    // que venham a reutilizar o mesmo endereço) e as posses em todos os
+    // grupos, devolvidas no destrutor thread_local quando o thread termina
+    struct ThreadBindings {
+        uint64_t groupId = 0;
+        MemoryArena* arena = nullptr;
+        std::vector<Lease> leases;
+
+        ~ThreadBindings() {
+            std::thread::id me = std::this_thread::get_id();
+            for (const Lease& lease : leases) lease.release(me);
+        }
+    };
+
+    static uint64_t nextGroupId() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static ThreadBindings& bindings() {
+        thread_local ThreadBindings current;
+        return current;
+    }
+
+private:
+    uint64_t id = nextGroupId();
+    size_t workerCount;
+    size_t bytesPerWorker;
+    MemoryArena reservation;
+    Worker* workersBegin = nullptr;
+    std::shared_ptr<Owners> owners;
+
+public:
+    ArenaGroup(size_t workers, size_t bytesPerWorker, ArenaOptions options = {})
+        : workerCount(workers),
+          bytesPerWorker((bytesPerWorker + kArenaAlignment - 1) & ~(kArenaAlignment - 1)),
+          reservation(workers * (sizeof(Worker) + this->bytesPerWorker), options),
+          owners(std::make_shared<Owners>(workers)) {
+        // Descritores primeiro, depois os blocos de cada worker, todos na mesma reserva
+        workersBegin = static_cast<Worker*>(reservation.allocate(sizeof(Worker) * workers, alignof(Worker)));
+        for (size_t i = 0; i < workers; ++i) {
+            void* storage = reservation.allocate(this->bytesPerWorker, kArenaAlignment);
+            new (workersBegin + i) Worker(storage, this->bytesPerWorker);
+        }
+    }
+
+    ~ArenaGroup() {
+        owners->groupAlive.store(false, std::memory_order_relaxed);
+        for (size_t i = 0; i < workerCount; ++i) workersBegin[i].~Worker();
+    }
+
+    ArenaGroup(const ArenaGroup&) = delete;
+    ArenaGroup& operator=(const ArenaGroup&) = delete;
+
+    // Sub-arena do thread atual. O caminho rápido é só uma leitura thread_local;
+    // a primeira chamada de cada thread pode alocar (registro da posse).
+    // Lança std::bad_alloc se todos os workers estiverem ocupados por threads vivos.
+    MemoryArena& local() {
+        ThreadBindings& cached = bindings();
+        if (cached.groupId == id) return *cached.arena;
+
+        MemoryArena& arena = claim(cached);
+        cached.groupId = id;
+        cached.arena = &arena;
+        return arena;
+    }
+
+    // Libera a sub-arena do thread atual para outro thread antes de ele
+    // terminar (o conteúdo fica)
+    void unbindCurrentThread() {
+        std::thread::id me = std::this_thread::get_id();
+        ThreadBindings& cached = bindings();
+        std::erase_if(cached.leases, [&](const Lease& lease) {
+            if (lease.owners != owners) return false;
+            lease.release(me);
+            return true;
+        });
+        if (cached.groupId == id) {
+            cached.groupId = 0;
+            cached.arena = nullptr;
+        }
+    }
+
+    MemoryArena& worker(size_t index) { return workersBegin[index].arena; }
+    size_t workers() const { return workerCount; }
+
+    // Apenas com os workers parados (entre jobs)
+    void resetAll() {
+        for (size_t i = 0; i < workerCount; ++i) workersBegin[i].arena.reset();
+    }
+
+    // Soma das estatísticas de todas as sub-arenas (com os workers parados)
+    ArenaStats stats() const {
+        ArenaStats total;
+        for (size_t i = 0; i < workerCount; ++i) {
+            ArenaStats s = workersBegin[i].arena.stats();
+            total.capacity += s.capacity;
+            total.used += s.used;
+            total.highWater += s.highWater;
+            total.paddingBytes += s.paddingBytes;
+            total.allocations += s.allocations;
+            total.failedAllocations += s.failedAllocations;
+            total.resets += s.resets;
+            for (size_t tag = 0; tag < kMaxArenaTags; ++tag) {
+                total.tags[tag].bytes += s.tags[tag].bytes;
+                total.tags[tag].allocations += s.tags[tag].allocations;
+            }
+        }
+        return total;
+    }
+
+private:
+    MemoryArena& claim(ThreadBindings& thread) {
+        std::thread::id me = std::this_thread::get_id();
+        for (size_t i = 0; i < workerCount; ++i) {
+            if (owners->slots[i].load(std::memory_order_acquire) == me) return workersBegin[i].arena;
+        }
+
+        // Descarta posses em grupos já destruídos (threads de longa duração)
+        std::erase_if(thread.leases, [](const Lease& lease) {
+            return !lease.owners->groupAlive.load(std::memory_order_relaxed);
+        });
+
+        for (size_t i = 0; i < workerCount; ++i) {
+            std::thread::id expected{};
+            if (owners->slots[i].compare_exchange_strong(expected, me, std::memory_order_acq_rel)) {
+                try {
+                    thread.leases.push_back({owners, i});
+                } catch (...) {
+                    owners->slots[i].store(std::thread::id{}, std::memory_order_release);
+                    throw;
+                }
+                return workersBegin[i].arena;
+            }
+        }
+        throw std::bad_alloc();
+    }
+};
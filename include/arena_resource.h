@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+#include "block_pool.h"
+#include "memory_arena.h"
+
+// O que fazer quando a memória pré-alocada acaba
+enum class ArenaFailure {
+    Abort,    // Reporta em stderr e aborta: falha determinística, sem exceções no RT
+    Throw,    // std::bad_alloc (contrato padrão de memory_resource)
+    Upstream  // Delega a outro resource (apenas fora do thread de áudio)
+};
+
+// Base comum: aplica a política de falha às alocações que não couberem
+class PreallocatedResource : public std::pmr::memory_resource {
+    ArenaFailure policy;
+    std::pmr::memory_resource* upstream;
+
+protected:
+    explicit PreallocatedResource(ArenaFailure policy, std::pmr::memory_resource* upstream)
+        : policy(policy), upstream(upstream ? upstream : std::pmr::get_default_resource()) {}
+
+    void* onFailure(size_t bytes, size_t alignment, const char* who) {
+        switch (policy) {
+        case ArenaFailure::Throw:
+            throw std::bad_alloc();
+        case ArenaFailure::Upstream:
+            return upstream->allocate(bytes, alignment);
+        case ArenaFailure::Abort:
+            break;
+        }
+        std::fprintf(stderr, "[%s] Memória pré-alocada esgotada (%zu bytes, alinhamento %zu)\n",
+                     who, bytes, alignment);
+        std::abort();
+    }
+
+    void releaseUpstream(void* p, size_t bytes, size_t alignment) {
+        upstream->deallocate(p, bytes, alignment);
+    }
+};
+
+// memory_resource sobre uma MemoryArena: permite std::pmr::vector e afins no
+// código do grafo com todos os bytes vindos da arena. deallocate() é no-op;
+// a memória volta com reset()/rewind() da arena.
+class ArenaResource : public PreallocatedResource {
+    MemoryArena& arena;
+
+public:
+    explicit ArenaResource(MemoryArena& arena, ArenaFailure policy = ArenaFailure::Abort,
+                           std::pmr::memory_resource* upstream = nullptr)
+        : PreallocatedResource(policy, upstream), arena(arena) {}
+
+    MemoryArena& underlying() { return arena; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = arena.tryAllocate(bytes, alignment);
+        return p ? p : onFailure(bytes, alignment, "ArenaResource");
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        if (!arena.owns(p)) releaseUpstream(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// memory_resource sobre um BlockPool: cada alocação de até blockSize() bytes
+// ocupa um bloco e volta ao pool individualmente. Use apenas no thread dono
+// do pool (ver BlockPool).
+class PoolResource : public PreallocatedResource {
+    BlockPool& pool;
+
+public:
+    explicit PoolResource(BlockPool& pool, ArenaFailure policy = ArenaFailure::Abort,
+                          std::pmr::memory_resource* upstream = nullptr)
+        : PreallocatedResource(policy, upstream), pool(pool) {}
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = bytes <= pool.blockSize() && alignment <= pool.alignment() ? pool.allocate() : nullptr;
+        return p ? p : onFailure(bytes, alignment, "PoolResource");
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        if (pool.owns(p)) pool.deallocate(p);
+        else releaseUpstream(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "memory_arena.h"
+#include "ring_buffer.h"
+
+// Ring SPSC com capacidade escolhida em runtime e storage não inicializado,
+// tomado de uma MemoryArena (ou de qualquer bloco alinhado fornecido).
+// Os elementos só existem entre push e pop, então tipos move-only e sem
+// construtor padrão funcionam (estes são lidos com consume(), que entrega o
+// elemento direto do slot). A capacidade é arredondada para potência de
+// dois para manter a indexação por máscara.
+template<typename T>
+class ArenaRingBuffer {
+private:
+    T* slots = nullptr;
+    size_t slotCount = 0;
+    uint64_t mask = 0;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeCount{0};
+    uint64_t cachedReadCount = 0;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> readCount{0};
+    uint64_t cachedWriteCount = 0;
+
+public:
+    // Capacidade efetiva necessária para pelo menos minCapacity elementos
+    static size_t roundCapacity(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+        return capacity;
+    }
+
+    static size_t storageBytes(size_t minCapacity) {
+        return roundCapacity(minCapacity) * sizeof(T);
+    }
+
+    // Lança std::bad_alloc se a arena não tiver espaço
+    ArenaRingBuffer(MemoryArena& arena, size_t minCapacity)
+        : ArenaRingBuffer(arena.allocate(storageBytes(minCapacity), std::max(alignof(T), kCacheLineSize)),
+                          storageBytes(minCapacity)) {}
+
+    // storage deve estar alinhado para T e ter pelo menos storageBytes() bytes;
+    // usa a maior potência de dois de elementos que couber
+    ArenaRingBuffer(void* storage, size_t bytes) : slots(static_cast<T*>(storage)) {
+        if (bytes < sizeof(T)) throw std::bad_alloc();
+        slotCount = 1;
+        while (slotCount * 2 * sizeof(T) <= bytes) slotCount <<= 1;
+        mask = slotCount - 1;
+    }
+
+    // O storage pertence à arena; aqui só destruímos os elementos vivos
+    ~ArenaRingBuffer() {
+        uint64_t end = writeCount.load(std::memory_order_acquire);
+        for (uint64_t i = readCount.load(std::memory_order_relaxed); i != end; ++i) {
+            std::destroy_at(slots + (i & mask));
+        }
+    }
+
+    ArenaRingBuffer(const ArenaRingBuffer&) = delete;
+    ArenaRingBuffer& operator=(const ArenaRingBuffer&) = delete;
+
+    template<typename... Args>
+    bool emplace(Args&&... args) {
+        uint64_t currentWrite = writeCount.load(std::memory_order_relaxed);
+
+        if (currentWrite - cachedReadCount == slotCount) {
+            cachedReadCount = readCount.load(std::memory_order_acquire);
+            if (currentWrite - cachedReadCount == slotCount) {
+                return false; // Buffer cheio
+            }
+        }
+
+        std::construct_at(slots + (currentWrite & mask), std::forward<Args>(args)...);
+        writeCount.store(currentWrite + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& item) { return emplace(item); }
+    bool push(T&& item) { return emplace(std::move(item)); }
+
+    // Move o elemento para fora e destrói o slot
+    bool pop(T& item) {
+        return consume([&](T&& slot) { item = std::move(slot); });
+    }
+
+    // Entrega o elemento ao callback (consumer(T&&)) direto no slot e depois o
+    // destrói; não exige um T já construído do lado de quem lê. Se o callback
+    // lançar, o elemento continua no ring.
+    template<typename F>
+    bool consume(F&& consumer) {
+        uint64_t currentRead = readCount.load(std::memory_order_relaxed);
+
+        if (currentRead == cachedWriteCount) {
+            cachedWriteCount = writeCount.load(std::memory_order_acquire);
+            if (currentRead == cachedWriteCount) {
+                return false; // Buffer vazio
+            }
+        }
+
+        T* slot = slots + (currentRead & mask);
+        std::forward<F>(consumer)(std::move(*slot));
+        std::destroy_at(slot);
+        readCount.store(currentRead + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t write_available() const {
+        return slotCount - (writeCount.load(std::memory_order_relaxed) -
+                            readCount.load(std::memory_order_acquire));
+    }
+
+    size_t read_available() const {
+        return writeCount.load(std::memory_order_acquire) -
+               readCount.load(std::memory_order_relaxed);
+    }
+
+    bool isEmpty() const {
+        return readCount.load(std::memory_order_relaxed) == writeCount.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return slotCount; }
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "memory_arena.h"
+
+// Pool de blocos de tamanho fixo (blocos de áudio, mensagens, estado de
+// vozes) tomados de uma MemoryArena na construção e reutilizados um a um.
+//
+// O thread dono (normalmente o de áudio) usa uma lista livre privada:
+// allocate() e deallocate() são wait-free, sem nenhuma instrução atômica no
+// caso comum. Outros threads (decoder) devolvem blocos com
+// deallocateRemote(), que empilha numa lista compartilhada lock-free; quando
+// a lista privada esvazia, o dono recolhe a compartilhada inteira com um
+// único exchange. Como nós nunca são retirados um a um da lista
+// compartilhada, não há problema de ABA e não são necessários tags.
+class BlockPool {
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+private:
+    uint8_t* base = nullptr;
+    size_t stride = 0;
+    size_t blockAlignment = 0;
+    size_t blockCount = 0;
+
+    alignas(kArenaAlignment) FreeNode* localHead = nullptr;
+    alignas(kArenaAlignment) std::atomic<FreeNode*> sharedHead{nullptr};
+
+public:
+    // Lança std::bad_alloc se a arena não comportar blockCount blocos
+    BlockPool(MemoryArena& arena, size_t blockSize, size_t blockCount, size_t alignment = kArenaAlignment)
+        : blockCount(blockCount) {
+        size_t size = blockSize < sizeof(FreeNode) ? sizeof(FreeNode) : blockSize;
+        if (alignment < alignof(FreeNode)) alignment = alignof(FreeNode);
+        blockAlignment = alignment;
+        stride = (size + alignment - 1) / alignment * alignment;
+        base = static_cast<uint8_t*>(arena.allocate(stride * blockCount, alignment));
+
+        for (size_t i = blockCount; i-- > 0;) {
+            localHead = new (base + i * stride) FreeNode{localHead};
+        }
+    }
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    // Apenas o thread dono. Retorna nullptr se o pool estiver esgotado.
+    void* allocate() {
+        if (!localHead) {
+            localHead = sharedHead.exchange(nullptr, std::memory_order_acquire);
+            if (!localHead) return nullptr;
+        }
+        FreeNode* node = localHead;
+        localHead = node->next;
+        return node;
+    }
+
+    // Apenas o thread dono
+    void deallocate(void* block) {
+        localHead = new (block) FreeNode{localHead};
+    }
+
+    // Qualquer thread. Lock-free: o CAS só repete se outro thread devolveu
+    // um bloco ao mesmo tempo.
+    void deallocateRemote(void* block) {
+        FreeNode* node = new (block) FreeNode{sharedHead.load(std::memory_order_relaxed)};
+        while (!sharedHead.compare_exchange_weak(node->next, node,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {}
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        if (sizeof(T) > stride || alignof(T) > blockAlignment) return nullptr;
+        void* mem = allocate();
+        return mem ? new (mem) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    template<typename T>
+    void destroy(T* obj) {
+        obj->~T();
+        deallocate(obj);
+    }
+
+    bool owns(const void* ptr) const {
+        const uint8_t* p = static_cast<const uint8_t*>(ptr);
+        return p >= base && p < base + stride * blockCount && (p - base) % stride == 0;
+    }
+
+    size_t blockSize() const { return stride; }
+    size_t alignment() const { return blockAlignment; }
+    size_t capacity() const { return blockCount; }
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "ring_buffer.h"
+
+// Ring de escritor único e múltiplos leitores (broadcast).
+// Cada item é escrito uma vez e lido por todos os leitores registrados, cada
+// um com seu próprio cursor em linha de cache separada.
+//
+// Leitores críticos (saída, gravação) seguram o escritor: push() falha se o
+// mais lento deles estiver Capacity itens atrás. Leitores não-críticos
+// (medidores) são ignorados pelo escritor; se ficarem para trás, pulam para
+// os dados mais recentes e contabilizam os itens perdidos em overruns().
+template<typename T, size_t Capacity, size_t MaxReaders = 8>
+class BroadcastRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity deve ser potência de dois");
+    // Leitores não-críticos podem ler um slot sendo sobrescrito (estilo seqlock)
+    // e descartam a cópia; isso só é seguro para tipos trivialmente copiáveis.
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "BroadcastRingBuffer requer T trivialmente copiável");
+    static constexpr uint64_t kMask = Capacity - 1;
+
+    struct alignas(kCacheLineSize) Cursor {
+        std::atomic<uint64_t> readCount{0};
+        std::atomic<bool> active{false};
+        std::atomic<bool> critical{true};
+        std::atomic<uint64_t> overruns{0}; // Escrito só pelo leitor; lido por qualquer thread
+    };
+
+private:
+    alignas(kCacheLineSize) std::array<T, Capacity> buffer;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeCount{0};
+    uint64_t cachedMinRead = 0;
+
+    std::array<Cursor, MaxReaders> cursors;
+
+public:
+    static constexpr int kInvalidReader = -1;
+
+    // Registra um leitor a partir da posição atual do escritor.
+    // Retorna o id do leitor ou kInvalidReader se não houver vaga.
+    int registerReader(bool critical = true) {
+        for (size_t i = 0; i < MaxReaders; ++i) {
+            bool expected = false;
+            if (cursors[i].active.load(std::memory_order_relaxed)) continue;
+            if (!cursors[i].active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) continue;
+
+            cursors[i].critical.store(critical, std::memory_order_relaxed);
+            cursors[i].overruns.store(0, std::memory_order_relaxed);
+            // Par com a barreira de slowestCriticalReader: ou o escritor vê
+            // este cursor ativo, ou aqui se lê a posição que ele já publicou
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cursors[i].readCount.store(writeCount.load(std::memory_order_acquire), std::memory_order_release);
+            return static_cast<int>(i);
+        }
+        return kInvalidReader;
+    }
+
+    void unregisterReader(int reader) {
+        cursors[reader].active.store(false, std::memory_order_release);
+    }
+
+    // Apenas o escritor. Falha somente se um leitor crítico estiver cheio.
+    bool push(const T& item) {
+        uint64_t currentWrite = writeCount.load(std::memory_order_relaxed);
+
+        if (currentWrite - cachedMinRead >= Capacity) {
+            // Só varre os cursores quando o buffer parece cheio
+            cachedMinRead = slowestCriticalReader(currentWrite);
+            if (currentWrite - cachedMinRead >= Capacity) {
+                return false; // Buffer cheio para algum leitor crítico
+            }
+        }
+
+        // Ordena a publicação anterior antes da sobrescrita do slot, para que
+        // leitores não-críticos detectem a volta completa
+        std::atomic_thread_fence(std::memory_order_release);
+        buffer[currentWrite & kMask] = item;
+        writeCount.store(currentWrite + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Apenas o dono do cursor `reader`.
+    bool pop(int reader, T& item) {
+        Cursor& cursor = cursors[reader];
+        uint64_t currentRead = cursor.readCount.load(std::memory_order_relaxed);
+
+        for (;;) {
+            uint64_t currentWrite = writeCount.load(std::memory_order_acquire);
+            if (currentRead == currentWrite) {
+                return false; // Buffer vazio
+            }
+
+            if (cursor.critical.load(std::memory_order_relaxed)) {
+                item = buffer[currentRead & kMask];
+                break;
+            }
+
+            // Leitor atrasado: pula para o item mais antigo ainda válido
+            if (currentWrite - currentRead >= Capacity) {
+                uint64_t oldest = currentWrite - Capacity + 1;
+                cursor.overruns.store(cursor.overruns.load(std::memory_order_relaxed) + oldest - currentRead,
+                                      std::memory_order_relaxed);
+                currentRead = oldest;
+            }
+
+            item = buffer[currentRead & kMask];
+
+            // Valida a cópia: se o escritor alcançou este slot, descarta e repete
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (writeCount.load(std::memory_order_relaxed) - currentRead < Capacity) {
+                break;
+            }
+        }
+
+        cursor.readCount.store(currentRead + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t read_available(int reader) const {
+        uint64_t currentWrite = writeCount.load(std::memory_order_acquire);
+        uint64_t currentRead = cursors[reader].readCount.load(std::memory_order_relaxed);
+        uint64_t pending = currentWrite - currentRead;
+        return pending > Capacity ? Capacity : static_cast<size_t>(pending);
+    }
+
+    // Itens perdidos por um leitor não-crítico que ficou para trás. Qualquer
+    // thread pode consultar (ex.: monitor de medição).
+    uint64_t overruns(int reader) const { return cursors[reader].overruns.load(std::memory_order_relaxed); }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    uint64_t slowestCriticalReader(uint64_t currentWrite) const {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Ver registerReader()
+        uint64_t slowest = currentWrite;
+        for (const Cursor& cursor : cursors) {
+            if (!cursor.active.load(std::memory_order_acquire)) continue;
+            if (!cursor.critical.load(std::memory_order_relaxed)) continue;
+            uint64_t read = cursor.readCount.load(std::memory_order_acquire);
+            if (read < slowest) slowest = read;
+        }
+        return slowest;
+    }
+};
@@ -0,0 +1,250 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "memory_arena.h"
+
+// Arena que cresce sob demanda para renderização offline (jobs em lote de
+// tamanho desconhecido). FORA do caminho de tempo real: quando o bloco atual
+// enche, mapeia um novo chunk com mmap, o que pode bloquear.
+//
+// reset() descarta tudo em O(nº de destrutores) mas mantém os chunks para o
+// próximo job; releaseUnused() devolve ao sistema os que sobrarem. Como na
+// MemoryArena: emplace com destrutores, mark()/rewind() e contabilidade por tag.
+class ChainedArena {
+    // Cabeçalho no início de cada chunk mapeado
+    struct Chunk {
+        Chunk* next;
+        size_t size; // Tamanho total mapeado, cabeçalho incluído
+    };
+
+    static constexpr size_t kHeaderSize = (sizeof(Chunk) + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+
+private:
+    size_t chunkSize;
+    Chunk* head = nullptr;
+    Chunk* current = nullptr; // nullptr antes da primeira alocação e após reset()
+    size_t offset = 0;        // Dentro de current
+    size_t consumedBefore = 0; // Bytes dos chunks anteriores a current
+    size_t totalCapacity = 0;
+    size_t chunkCount = 0;
+    uint8_t currentTag = 0;
+    ArenaStats counters;
+    ArenaDestructorList destructors;
+
+public:
+    // chunkSize é arredondado para páginas; pedidos maiores ganham chunk próprio.
+    // Nenhuma memória é mapeada até a primeira alocação.
+    explicit ChainedArena(size_t chunkSize = 1024 * 1024)
+        : chunkSize(roundToPages(chunkSize < 2 * kHeaderSize ? 2 * kHeaderSize : chunkSize)) {}
+
+    ~ChainedArena() {
+        destructors.runFrom(0);
+        while (head) {
+            Chunk* next = head->next;
+            unmapChunk(head);
+            head = next;
+        }
+    }
+
+    ChainedArena(const ChainedArena&) = delete;
+    ChainedArena& operator=(const ChainedArena&) = delete;
+
+    // Lança std::bad_alloc apenas se o sistema recusar um novo chunk
+    void* allocate(size_t size, size_t alignment = 16) {
+        void* ptr = tryAllocate(size, alignment);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void* tryAllocate(size_t size, size_t alignment = 16) noexcept {
+        if (current) {
+            if (void* ptr = bump(size, alignment)) return ptr;
+        }
+
+        // Reaproveita o próximo chunk da cadeia (sobra de um job anterior) se
+        // couber; senão mapeia um novo e o encaixa logo após o atual
+        size_t slack = kHeaderSize + (alignment > kArenaAlignment ? alignment : 0);
+        if (size > std::numeric_limits<size_t>::max() - slack - chunkSize) {
+            // Nenhum chunk comportaria; evita que needed e roundToPages deem a volta
+            ++counters.failedAllocations;
+            return nullptr;
+        }
+        size_t needed = slack + size;
+        Chunk* next = current ? current->next : head;
+        if (!next || next->size < needed) {
+            Chunk* fresh = mapChunk(needed > chunkSize ? roundToPages(needed) : chunkSize);
+            if (!fresh) {
+                ++counters.failedAllocations;
+                return nullptr;
+            }
+            fresh->next = next;
+            if (current) current->next = fresh;
+            else head = fresh;
+            next = fresh;
+        }
+
+        if (current) consumedBefore += current->size;
+        current = next;
+        offset = kHeaderSize;
+        return bump(size, alignment);
+    }
+
+    // Mesma semântica de MemoryArena::emplace: destrutores não-triviais rodam
+    // em ordem inversa no reset(), rewind() ou na destruição da arena
+    template<typename T, typename... Args>
+    T* emplace(Args&&... args) {
+        return destructors.emplace<T>(*this, std::forward<Args>(args)...);
+    }
+
+    // Descarta todas as alocações; os chunks continuam mapeados e são
+    // reutilizados em ordem pelo próximo job
+    void reset() {
+        destructors.runFrom(0);
+        current = nullptr;
+        offset = 0;
+        consumedBefore = 0;
+        ++counters.resets;
+        counters.tags = {};
+    }
+
+    // Posição em bytes consumidos (used()); rewind() volta ao chunk que a
+    // contém. Marcadores obsoletos (anteriores a um reset() ou além da
+    // posição atual) são ignorados, como na MemoryArena.
+    ArenaMarker mark() const { return {used(), counters.resets}; }
+    void rewind(ArenaMarker marker) {
+        if (marker.resets != counters.resets || marker.offset > used()) return;
+        destructors.runFrom(marker.offset);
+
+        if (marker.offset == 0) {
+            current = nullptr;
+            offset = 0;
+            consumedBefore = 0;
+            return;
+        }
+        // Os chunks consumidos são exatamente os da cabeça até current, em ordem
+        size_t before = 0;
+        Chunk* chunk = head;
+        while (marker.offset > before + chunk->size) {
+            before += chunk->size;
+            chunk = chunk->next;
+        }
+        current = chunk;
+        consumedBefore = before;
+        offset = marker.offset - before;
+    }
+
+    uint8_t setTag(uint8_t tag) {
+        uint8_t previous = currentTag;
+        currentTag = tag < kMaxArenaTags ? tag : 0;
+        return previous;
+    }
+
+    // Devolve ao sistema os chunks que não estão em uso, mantendo mapeados no
+    // máximo keepBytes (contando os em uso). Normalmente chamado após reset(),
+    // no fim de um job maior que o habitual. Retorna os bytes liberados.
+    size_t releaseUnused(size_t keepBytes = 0) {
+        size_t kept = 0;
+        Chunk** link = &head;
+        if (current) {
+            for (Chunk* c = head; c != current->next; c = c->next) kept += c->size;
+            link = &current->next;
+        }
+
+        size_t released = 0;
+        while (Chunk* c = *link) {
+            if (kept + c->size <= keepBytes) {
+                kept += c->size;
+                link = &c->next;
+                continue;
+            }
+            *link = c->next;
+            released += c->size;
+            unmapChunk(c);
+        }
+        return released;
+    }
+
+    // Bytes consumidos desde o último reset(), incluindo cabeçalhos e as
+    // sobras no fim de cada chunk já ultrapassado
+    size_t used() const { return consumedBefore + offset; }
+    size_t capacity() const { return totalCapacity; }
+    size_t chunks() const { return chunkCount; }
+
+    ArenaStats stats() const {
+        ArenaStats s = counters;
+        s.capacity = totalCapacity;
+        s.used = used();
+        return s;
+    }
+
+    bool owns(const void* ptr) const {
+        const uint8_t* p = static_cast<const uint8_t*>(ptr);
+        for (Chunk* c = head; c; c = c->next) {
+            const uint8_t* base = reinterpret_cast<const uint8_t*>(c);
+            if (p >= base + kHeaderSize && p < base + c->size) return true;
+        }
+        return false;
+    }
+
+private:
+    void* bump(size_t size, size_t alignment) noexcept {
+        uint8_t* base = reinterpret_cast<uint8_t*>(current);
+        uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+        size_t padding = (alignment - (address % alignment)) % alignment;
+        size_t remaining = current->size - offset;
+        if (padding > remaining || size > remaining - padding) return nullptr;
+
+        offset += padding;
+        void* ptr = base + offset;
+        offset += size;
+
+        ++counters.allocations;
+        counters.paddingBytes += padding;
+        if (used() > counters.highWater) counters.highWater = used();
+        counters.tags[currentTag].bytes += size;
+        ++counters.tags[currentTag].allocations;
+        return ptr;
+    }
+
+    static size_t roundToPages(size_t bytes) {
+        size_t page = 4096;
+#ifdef __linux__
+        page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        return (bytes + page - 1) / page * page;
+    }
+
+    Chunk* mapChunk(size_t bytes) noexcept {
+#ifdef __linux__
+        void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) return nullptr;
+#else
+        void* mem = ::operator new(bytes, std::align_val_t{kArenaAlignment}, std::nothrow);
+        if (!mem) return nullptr;
+#endif
+        totalCapacity += bytes;
+        ++chunkCount;
+        return new(mem) Chunk{nullptr, bytes};
+    }
+
+    void unmapChunk(Chunk* chunk) noexcept {
+        totalCapacity -= chunk->size;
+        --chunkCount;
+#ifdef __linux__
+        munmap(chunk, chunk->size);
+#else
+        ::operator delete(chunk, std::align_val_t{kArenaAlignment});
+#endif
+    }
+};
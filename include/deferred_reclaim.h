@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+
+#include "ring_buffer.h"
+
+// Objeto aposentado pelo thread de áudio, com a função que sabe destruí-lo
+struct RetiredObject {
+    void* ptr = nullptr;
+    void (*deleter)(void*) = nullptr;
+};
+
+// Canal de "lixo": o thread de áudio aposenta objetos que não usa mais (nós
+// substituídos, tabelas de coeficientes, buffers decodificados) e um thread
+// de manutenção os destrói. Assim free()/destrutores nunca rodam no caminho
+// crítico. retire() é um push SPSC sem alocação; collect() roda fora do RT.
+template<size_t Capacity = 256>
+class DeferredReclaimQueue {
+private:
+    PowerOfTwoRingBuffer<RetiredObject, Capacity> queue;
+
+public:
+    DeferredReclaimQueue() = default;
+    DeferredReclaimQueue(const DeferredReclaimQueue&) = delete;
+    DeferredReclaimQueue& operator=(const DeferredReclaimQueue&) = delete;
+
+    // O que sobrar é destruído junto com a fila (fora do thread de áudio)
+    ~DeferredReclaimQueue() { collect(); }
+
+    // Apenas o thread de áudio. Se a fila estiver cheia retorna false e o
+    // objeto continua sob responsabilidade do chamador (tente no próximo bloco).
+    bool retire(void* ptr, void (*deleter)(void*)) {
+        return queue.push(RetiredObject{ptr, deleter});
+    }
+
+    template<typename T>
+    bool retire(T* obj) {
+        return retire(obj, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // Só libera a posse do unique_ptr se o objeto entrou na fila
+    template<typename T>
+    bool retire(std::unique_ptr<T>& obj) {
+        if (!retire(obj.get())) return false;
+        obj.release();
+        return true;
+    }
+
+    // Apenas o thread de manutenção: destrói tudo o que foi aposentado
+    size_t collect() {
+        size_t destroyed = 0;
+        RetiredObject retired;
+        while (queue.pop(retired)) {
+            retired.deleter(retired.ptr);
+            ++destroyed;
+        }
+        return destroyed;
+    }
+
+    size_t pending() const { return queue.read_available(); }
+};
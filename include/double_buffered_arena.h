@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+#include "memory_arena.h"
+
+// Par de arenas (A/B) para reconfigurar o grafo sem glitch e sem heap.
+// O thread de controle monta o próximo grafo na arena inativa e o publica;
+// o thread de áudio troca para ele com uma única operação atômica no início
+// do bloco. A arena antiga só é resetada (rodando os destrutores do grafo
+// antigo, no thread de controle) depois que o áudio confirmou a troca.
+//
+// Root é o objeto raiz do grafo, alocado na arena devolvida por beginBuild().
+template<typename Root>
+class DoubleBufferedArena {
+private:
+    MemoryArena arenas[2];
+
+    // Controle -> áudio: raiz publicada e ainda não adotada.
+    // Volta a nullptr quando o áudio adota, o que serve de confirmação.
+    alignas(kArenaAlignment) std::atomic<Root*> published{nullptr};
+
+    // Apenas o thread de controle
+    size_t buildIndex = 0;
+
+    // Apenas o thread de áudio
+    alignas(kArenaAlignment) Root* current = nullptr;
+
+public:
+    DoubleBufferedArena(size_t bytesPerArena, ArenaOptions options = {})
+        : arenas{MemoryArena(bytesPerArena, options), MemoryArena(bytesPerArena, options)} {}
+
+    DoubleBufferedArena(const DoubleBufferedArena&) = delete;
+    DoubleBufferedArena& operator=(const DoubleBufferedArena&) = delete;
+
+    // Apenas o controle. Retorna a arena inativa, já resetada, para montar o
+    // próximo grafo; ou nullptr se a troca anterior ainda não foi confirmada.
+    MemoryArena* beginBuild() {
+        if (swapPending()) return nullptr;
+        MemoryArena& arena = arenas[buildIndex];
+        arena.reset();
+        return &arena;
+    }
+
+    // Apenas o controle. root deve ter sido alocado na arena de beginBuild().
+    void publish(Root* root) {
+        published.store(root, std::memory_order_release);
+        buildIndex ^= 1;
+    }
+
+    // Apenas o controle: true enquanto o áudio não adotou a última publicação
+    bool swapPending() const {
+        return published.load(std::memory_order_acquire) != nullptr;
+    }
+
+    // Apenas o thread de áudio, uma vez no início de cada bloco. Sem bloqueio
+    // nem RMW no caso comum (nada novo publicado).
+    Root* acquire() {
+        if (published.load(std::memory_order_relaxed)) {
+            current = published.exchange(nullptr, std::memory_order_acq_rel);
+        }
+        return current;
+    }
+};
@@ -1,43 +1,397 @@
 #pragma once
-#include <vector>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+// Alinhamento mínimo do bloco da arena: uma linha de cache, o que também
+// cobre cargas AVX/AVX-512 alinhadas
+inline constexpr size_t kArenaAlignment = 64;
+
+enum class ArenaPages {
+    Default,         // Memória alinhada comum
+    TransparentHuge, // mmap + madvise(MADV_HUGEPAGE): o kernel usa páginas de 2 MB quando puder
+    ExplicitHuge     // mmap(MAP_HUGETLB): exige páginas reservadas; cai para Default se faltar
+};
+
+struct ArenaOptions {
+    ArenaPages pages = ArenaPages::Default;
+    bool prefault = false;  // Toca todas as páginas na construção (sem page fault depois)
+    bool lockPages = false; // mlock: impede que as páginas voltem para swap
+};
+
+// Page faults menores do thread atual; a diferença antes/depois de um trecho
+// confirma que ele não tocou páginas novas
+inline long currentMinorFaults() {
+#ifdef __linux__
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) return usage.ru_minflt;
+#endif
+    return 0;
+}
+
+// Número de tags de contabilidade (0 = sem tag)
+inline constexpr size_t kMaxArenaTags = 16;
+
+struct ArenaTagStats {
+    size_t bytes = 0;
+    uint64_t allocations = 0;
+};
+
+// Estatísticas de uso da arena. highWater sobrevive a reset(); os demais
+// contadores são desde a construção, exceto os por tag, que valem desde o
+// último reset() (rewind() não os desconta).
+struct ArenaStats {
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t highWater = 0;         // Maior offset já atingido
+    size_t paddingBytes = 0;      // Bytes perdidos em alinhamento
+    uint64_t allocations = 0;
+    uint64_t failedAllocations = 0;
+    uint64_t resets = 0;
+    std::array<ArenaTagStats, kMaxArenaTags> tags{};
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ArenaStats& s) {
+    os << "[Arena] usado " << s.used << " / " << s.capacity << " bytes, pico " << s.highWater
+       << ", " << s.allocations << " alocações (" << s.failedAllocations << " falhas), padding "
+       << s.paddingBytes << " bytes, " << s.resets << " resets\n";
+    for (size_t tag = 0; tag < kMaxArenaTags; ++tag) {
+        if (s.tags[tag].allocations == 0) continue;
+        os << "[Arena]   tag " << tag << ": " << s.tags[tag].bytes << " bytes em "
+           << s.tags[tag].allocations << " alocações\n";
+    }
+    return os;
+}
+
+// Nó da lista intrusiva de destrutores, alocado na própria arena ao lado de
+// cada objeto não-trivialmente destrutível criado por emplace()
+struct ArenaDestructor {
+    ArenaDestructor* previous;
+    void (*destroy)(void*);
+    void* object;
+    size_t end; // used() da arena logo após o objeto
+};
+
+// Registro de destrutores compartilhado pelas arenas (MemoryArena,
+// ChainedArena). Tipos com destrutor não-trivial ganham um nó alocado na
+// própria arena e são destruídos em ordem inversa; tipos triviais não pagam
+// nada: o registro é eliminado em tempo de compilação.
+class ArenaDestructorList {
+    ArenaDestructor* head = nullptr; // Mais recente primeiro
+
+public:
+    // Aloca em arena (allocate(size, alignment) e used())
+    template<typename T, typename Arena, typename... Args>
+    T* emplace(Arena& arena, Args&&... args) {
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            void* mem = arena.allocate(sizeof(T), alignof(T));
+            return new(mem) T(std::forward<Args>(args)...);
+        } else {
+            void* nodeMem = arena.allocate(sizeof(ArenaDestructor), alignof(ArenaDestructor));
+            void* mem = arena.allocate(sizeof(T), alignof(T));
+            T* obj = new(mem) T(std::forward<Args>(args)...);
+            // Só registra depois que o construtor terminou sem exceção
+            head = new(nodeMem) ArenaDestructor{
+                head, [](void* p) { static_cast<T*>(p)->~T(); }, obj, arena.used()};
+            return obj;
+        }
+    }
+
+    // Destrói, do mais recente para o mais antigo, todo objeto que termina
+    // além de `position` (em used()), isto é, cuja memória está sendo
+    // descartada. runFrom(0) destrói todos. Limitar pela posição, e não por um
+    // nó salvo, mantém corretos os marcadores cujo nó já foi destruído por um
+    // rewind() anterior.
+    void runFrom(size_t position) {
+        while (head && head->end > position) {
+            ArenaDestructor* node = head;
+            head = node->previous;
+            node->destroy(node->object);
+        }
+    }
+};
+
+// Posição salva da arena para rewind(). resets identifica a geração: um
+// marcador tirado antes de um reset() fica obsoleto.
+struct ArenaMarker {
+    size_t offset = 0;
+    uint64_t resets = 0;
+};
 
 class MemoryArena {
 private:
-    std::vector<uint8_t> buffer;
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+    uint8_t* buffer = nullptr;
+    size_t bufferSize = 0;
+    size_t mappedSize = 0; // != 0 quando o bloco veio de mmap
+    bool hugePages = false;       // Huge pages explícitas (MAP_HUGETLB)
+    bool transparentHuge = false; // Região marcada com MADV_HUGEPAGE
+    bool locked = false;
+    bool ownsBlock = true;
     size_t offset = 0;
+    uint8_t currentTag = 0;
+    ArenaStats counters;
+    ArenaDestructorList destructors;
     
 public:
-    explicit MemoryArena(size_t size) : buffer(size) {
+    explicit MemoryArena(size_t size, ArenaOptions options = {}) : bufferSize(size) {
+        acquire(options);
+        if (options.lockPages) lockBlock();
+        if (options.prefault) prefaultBlock();
         std::cout << "[Arena] Alocados " << size / 1024 << " KB\n";
     }
+
+    // Arena sobre um bloco externo (não assume a posse). O bloco deve estar
+    // alinhado em kArenaAlignment para que os alinhamentos pedidos valham.
+    MemoryArena(void* storage, size_t size) : MemoryArena(static_cast<uint8_t*>(storage), size) {}
+
+    // constexpr: permite inicialização constante (constinit) sobre storage
+    // estático, sem nenhuma inicialização dinâmica (ver StaticArena)
+    constexpr MemoryArena(uint8_t* storage, size_t size)
+        : buffer(storage), bufferSize(size), ownsBlock(false) {}
+
+    ~MemoryArena() {
+        destructors.runFrom(0);
+        releaseBlock();
+    }
     
     // Desabilita cópia para evitar erros de ponteiro
     MemoryArena(const MemoryArena&) = delete;
     MemoryArena& operator=(const MemoryArena&) = delete;
 
     void* allocate(size_t size, size_t alignment = 16) {
-        size_t padding = (alignment - (offset % alignment)) % alignment;
-        
-        if (offset + padding + size > buffer.size()) {
+        void* ptr = tryAllocate(size, alignment);
+        if (!ptr) {
             throw std::bad_alloc();
         }
+        return ptr;
+    }
+
+    // Versão sem exceção: retorna nullptr quando a arena está cheia
+    void* tryAllocate(size_t size, size_t alignment = 16) noexcept {
+        // Padding calculado sobre o endereço real, não só sobre o offset
+        uintptr_t current = reinterpret_cast<uintptr_t>(buffer) + offset;
+        size_t padding = (alignment - (current % alignment)) % alignment;
+        
+        // Sem somar offset + padding + size, que daria a volta para size enorme
+        size_t remaining = bufferSize - offset;
+        if (padding > remaining || size > remaining - padding) {
+            ++counters.failedAllocations;
+            return nullptr;
+        }
 
         offset += padding;
-        void* ptr = buffer.data() + offset;
+        void* ptr = buffer + offset;
         offset += size;
+
+        ++counters.allocations;
+        counters.paddingBytes += padding;
+        if (offset > counters.highWater) counters.highWater = offset;
+        counters.tags[currentTag].bytes += size;
+        ++counters.tags[currentTag].allocations;
         return ptr;
     }
     
+    // Tipos com destrutor não-trivial são registrados e destruídos em ordem
+    // inversa no reset(), rewind() ou destruição da arena (ArenaDestructorList)
     template<typename T, typename... Args>
     T* emplace(Args&&... args) {
-        void* mem = allocate(sizeof(T), alignof(T));
-        return new(mem) T(std::forward<Args>(args)...);
+        return destructors.emplace<T>(*this, std::forward<Args>(args)...);
     }
     
-    void reset() { offset = 0; }
+    void reset() {
+        destructors.runFrom(0);
+        offset = 0;
+        ++counters.resets;
+        counters.tags = {};
+    }
+
+    // Marca a posição atual; rewind() descarta tudo o que foi alocado depois
+    // dela em O(1), sem afetar as alocações anteriores. Um marcador obsoleto
+    // (anterior a um reset(), ou além da posição atual) é ignorado.
+    ArenaMarker mark() const { return {offset, counters.resets}; }
+    void rewind(ArenaMarker marker) {
+        if (marker.resets != counters.resets || marker.offset > offset) return;
+        destructors.runFrom(marker.offset);
+        offset = marker.offset;
+    }
+
+    // Reserva uma região separada para rascunho por bloco (FFT, buffers de
+    // trabalho), que pode ser resetada sem tocar nas alocações persistentes
+    MemoryArena carveScratch(size_t size) {
+        return MemoryArena(allocate(size, kArenaAlignment), size);
+    }
     size_t used() const { return offset; }
-    size_t capacity() const { return buffer.size(); }
+    size_t capacity() const { return bufferSize; }
+
+    ArenaStats stats() const {
+        ArenaStats s = counters;
+        s.capacity = bufferSize;
+        s.used = offset;
+        return s;
+    }
+
+    // Tag atribuída às próximas alocações (ex.: um id por tipo de nó).
+    // Retorna a anterior; tags fora do intervalo caem em 0.
+    uint8_t setTag(uint8_t tag) {
+        uint8_t previous = currentTag;
+        currentTag = tag < kMaxArenaTags ? tag : 0;
+        return previous;
+    }
+
+    bool owns(const void* ptr) const {
+        const uint8_t* p = static_cast<const uint8_t*>(ptr);
+        return p >= buffer && p < buffer + bufferSize;
+    }
+
+    // true se o bloco usa páginas enormes. Para THP reflete o que o kernel de
+    // fato entregou até agora (lido de /proc/self/smaps): sem prefault, só
+    // depois que as páginas forem tocadas. Não chamar no thread de áudio.
+    bool usesHugePages() const { return hugePages || (transparentHuge && transparentHugeBytes() > 0); }
+
+    // true se o mlock pedido em ArenaOptions teve sucesso
+    bool isLocked() const { return locked; }
+
+private:
+    void acquire(const ArenaOptions& options) {
+#ifdef __linux__
+        if (options.pages != ArenaPages::Default && bufferSize > 0) {
+            size_t length = (bufferSize + kHugePageSize - 1) & ~(kHugePageSize - 1);
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+            if (options.pages == ArenaPages::ExplicitHuge) {
+                int populate = options.prefault ? MAP_POPULATE : 0;
+                void* mem = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | populate, -1, 0);
+                if (mem != MAP_FAILED) {
+                    adopt(mem, length, true);
+                    return;
+                }
+            } else {
+                // THP só cobre regiões alinhadas em 2 MB: mapeia a mais e apara as pontas.
+                // Sem MAP_POPULATE: páginas tocadas antes do madvise seriam de 4 KB;
+                // o prefault vem depois, em prefaultBlock()
+                void* mem = mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+                if (mem != MAP_FAILED) {
+                    uintptr_t raw = reinterpret_cast<uintptr_t>(mem);
+                    uintptr_t aligned = (raw + kHugePageSize - 1) & ~(kHugePageSize - 1);
+                    size_t head = aligned - raw;
+                    if (head) munmap(mem, head);
+                    munmap(reinterpret_cast<void*>(aligned + length), kHugePageSize - head);
+
+                    void* region = reinterpret_cast<void*>(aligned);
+                    adopt(region, length, false);
+                    transparentHuge = madvise(region, length, MADV_HUGEPAGE) == 0;
+                    return;
+                }
+            }
+        }
+#endif
+        buffer = static_cast<uint8_t*>(::operator new(bufferSize, std::align_val_t{kArenaAlignment}));
+    }
+
+    void adopt(void* mem, size_t length, bool huge) {
+        buffer = static_cast<uint8_t*>(mem);
+        mappedSize = length;
+        hugePages = huge;
+    }
+
+    void lockBlock() {
+#ifdef __linux__
+        locked = bufferSize > 0 && mlock(buffer, bufferSize) == 0;
+        if (!locked) std::cerr << "[Arena] Aviso: mlock falhou (verifique RLIMIT_MEMLOCK)\n";
+#endif
+    }
+
+    // Escreve em cada página para forçar o fault agora, na thread que constrói
+    // a arena, e não depois no thread de áudio
+    void prefaultBlock() {
+#if defined(__linux__) && defined(MADV_POPULATE_WRITE)
+        // Kernel >= 5.14: popula de uma vez, respeitando MADV_HUGEPAGE
+        if (mappedSize && madvise(buffer, mappedSize, MADV_POPULATE_WRITE) == 0) return;
+#endif
+        size_t page = 4096;
+#ifdef __linux__
+        page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        volatile uint8_t* bytes = buffer;
+        for (size_t i = 0; i < bufferSize; i += page) bytes[i] = 0;
+        if (bufferSize > 0) bytes[bufferSize - 1] = 0;
+    }
+
+    // Bytes do bloco cobertos por huge pages transparentes (AnonHugePages
+    // somado sobre os mapeamentos que intersectam o bloco)
+    size_t transparentHugeBytes() const {
+        size_t total = 0;
+#ifdef __linux__
+        FILE* smaps = std::fopen("/proc/self/smaps", "r");
+        if (!smaps) return 0;
+
+        uintptr_t begin = reinterpret_cast<uintptr_t>(buffer);
+        uintptr_t end = begin + bufferSize;
+        bool inside = false;
+        char line[256];
+        while (std::fgets(line, sizeof(line), smaps)) {
+            unsigned long start = 0, stop = 0;
+            size_t kb = 0;
+            if (std::sscanf(line, "%lx-%lx ", &start, &stop) == 2) {
+                inside = start < end && stop > begin;
+            } else if (inside && std::sscanf(line, "AnonHugePages: %zu kB", &kb) == 1) {
+                total += kb * 1024;
+            }
+        }
+        std::fclose(smaps);
+#endif
+        return total;
+    }
+
+    void releaseBlock() {
+        if (!buffer || !ownsBlock) return;
+#ifdef __linux__
+        if (locked) munlock(buffer, bufferSize);
+        if (mappedSize) {
+            munmap(buffer, mappedSize);
+            return;
+        }
+#endif
+        ::operator delete(buffer, std::align_val_t{kArenaAlignment});
+    }
+};
+
+// Restaura a posição da arena ao sair do escopo: alocações temporárias dentro
+// de um process() somem automaticamente no fim do bloco
+class ArenaScope {
+    MemoryArena& arena;
+    ArenaMarker marker;
+
+public:
+    explicit ArenaScope(MemoryArena& a) : arena(a), marker(a.mark()) {}
+    ~ArenaScope() { arena.rewind(marker); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+// Contabiliza as alocações do escopo sob uma tag e restaura a anterior
+class ArenaTagScope {
+    MemoryArena& arena;
+    uint8_t previous;
+
+public:
+    ArenaTagScope(MemoryArena& a, uint8_t tag) : arena(a), previous(a.setTag(tag)) {}
+    ~ArenaTagScope() { arena.setTag(previous); }
+
+    ArenaTagScope(const ArenaTagScope&) = delete;
+    ArenaTagScope& operator=(const ArenaTagScope&) = delete;
 };
\ No newline at end of file
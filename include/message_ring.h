@@ -0,0 +1,143 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "ring_buffer.h"
+
+// Ring SPSC orientado a bytes para mensagens heterogêneas de controle
+// (parâmetros, edições de grafo, transporte). Cada registro ocupa apenas o
+// tamanho da sua mensagem: cabeçalho com tamanho e tipo, seguido do payload
+// alinhado. Quando um registro não cabe antes do fim do buffer, um registro
+// de padding preenche a sobra e a mensagem começa no início.
+//
+// Os tipos aceitos são fixados na lista Messages; o id de cada tipo é sua
+// posição na lista, então produtor e consumidor concordam por construção.
+template<size_t CapacityBytes, typename... Messages>
+class MessageRing {
+    static constexpr size_t kAlign = 16;
+
+    static_assert(CapacityBytes >= 64 && (CapacityBytes & (CapacityBytes - 1)) == 0,
+                  "CapacityBytes deve ser potência de dois");
+    static_assert(sizeof...(Messages) > 0, "MessageRing precisa de ao menos um tipo de mensagem");
+    static_assert((std::is_trivially_copyable_v<Messages> && ...),
+                  "Mensagens devem ser trivialmente copiáveis");
+    static_assert(((alignof(Messages) <= kAlign) && ...),
+                  "Alinhamento da mensagem excede o alinhamento do registro");
+
+    struct Header {
+        uint32_t size; // Tamanho total do registro (cabeçalho + payload + padding)
+        uint32_t type;
+    };
+
+    static constexpr uint64_t kMask = CapacityBytes - 1;
+    static constexpr uint32_t kPaddingType = 0;
+    static constexpr size_t kHeaderSize = (sizeof(Header) + kAlign - 1) & ~(kAlign - 1);
+
+    template<typename Msg>
+    static constexpr size_t recordSize = kHeaderSize + ((sizeof(Msg) + kAlign - 1) & ~(kAlign - 1));
+
+    template<typename Msg, typename First, typename... Rest>
+    static constexpr uint32_t indexOf() {
+        if constexpr (std::is_same_v<Msg, First>) return 1;
+        else {
+            static_assert(sizeof...(Rest) > 0, "Tipo de mensagem não registrado neste MessageRing");
+            return 1 + indexOf<Msg, Rest...>();
+        }
+    }
+
+    // Ids começam em 1; 0 é reservado para o registro de padding
+    template<typename Msg>
+    static constexpr uint32_t typeId = indexOf<Msg, Messages...>();
+
+private:
+    alignas(kCacheLineSize) std::array<std::byte, CapacityBytes> buffer;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeCount{0};
+    uint64_t cachedReadCount = 0;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> readCount{0};
+
+public:
+    // Apenas o produtor. Retorna false se não houver espaço (nada é escrito).
+    template<typename Msg>
+    bool send(const Msg& msg) {
+        static_assert(recordSize<Msg> <= CapacityBytes, "Mensagem maior que o ring");
+        constexpr size_t size = recordSize<Msg>;
+
+        uint64_t currentWrite = writeCount.load(std::memory_order_relaxed);
+        size_t offset = currentWrite & kMask;
+        size_t tail = CapacityBytes - offset;
+        size_t needed = size <= tail ? size : tail + size;
+
+        if (CapacityBytes - (currentWrite - cachedReadCount) < needed) {
+            cachedReadCount = readCount.load(std::memory_order_acquire);
+            if (CapacityBytes - (currentWrite - cachedReadCount) < needed) {
+                return false; // Buffer cheio
+            }
+        }
+
+        if (size > tail) {
+            // Registro não cabe até o fim: pula a sobra com um padding
+            writeHeader(offset, tail, kPaddingType);
+            currentWrite += tail;
+            offset = 0;
+        }
+
+        writeHeader(offset, size, typeId<Msg>);
+        new (buffer.data() + offset + kHeaderSize) Msg(msg);
+        writeCount.store(currentWrite + size, std::memory_order_release);
+        return true;
+    }
+
+    // Apenas o consumidor. Entrega cada mensagem pendente ao visitor pelo seu
+    // tipo concreto (visitor(const Msg&)) e libera todo o espaço de uma vez.
+    // Sem alocação; pensado para rodar no início de cada bloco de áudio.
+    template<typename Visitor>
+    size_t drain(Visitor&& visitor) {
+        uint64_t currentRead = readCount.load(std::memory_order_relaxed);
+        uint64_t currentWrite = writeCount.load(std::memory_order_acquire);
+        size_t delivered = 0;
+
+        while (currentRead != currentWrite) {
+            std::byte* record = buffer.data() + (currentRead & kMask);
+            const Header* header = std::launder(reinterpret_cast<const Header*>(record));
+
+            if (header->type != kPaddingType) {
+                dispatch(header->type, record + kHeaderSize, visitor);
+                ++delivered;
+            }
+            currentRead += header->size;
+        }
+
+        readCount.store(currentRead, std::memory_order_release);
+        return delivered;
+    }
+
+    bool isEmpty() const {
+        return readCount.load(std::memory_order_relaxed) == writeCount.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() { return CapacityBytes; }
+
+private:
+    void writeHeader(size_t offset, size_t size, uint32_t type) {
+        new (buffer.data() + offset) Header{static_cast<uint32_t>(size), type};
+    }
+
+    template<typename Visitor>
+    static void dispatch(uint32_t type, std::byte* payload, Visitor& visitor) {
+        ((type == typeId<Messages>
+              ? (visitor(*std::launder(reinterpret_cast<const Messages*>(payload))), true)
+              : false) || ...);
+    }
+};
+
+// Combina lambdas num único visitor para MessageRing::drain
+template<typename... Fs>
+struct Overloaded : Fs... {
+    using Fs::operator()...;
+};
@@ -0,0 +1,146 @@
+#pragma once
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "ring_buffer.h"
+
+// Ring SPSC com capacidade definida em runtime, cujo storage é mapeado duas
+// vezes em sequência na memória virtual (mesmas páginas físicas via memfd).
+// Escrever além do fim do primeiro mapeamento cai no início do buffer, então
+// qualquer região legível ou gravável é um único intervalo contíguo e
+// kernels SIMD podem rodar direto sobre o ring, sem cópia intermediária.
+template<typename T>
+class MirroredRingBuffer {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "MirroredRingBuffer requer T trivialmente copiável");
+    static_assert((sizeof(T) & (sizeof(T) - 1)) == 0,
+                  "sizeof(T) deve ser potência de dois para dividir a página");
+
+private:
+    T* data = nullptr;
+    size_t bytes = 0;
+    size_t slots = 0;
+    uint64_t mask = 0;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeCount{0};
+    uint64_t cachedReadCount = 0;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> readCount{0};
+    uint64_t cachedWriteCount = 0;
+
+public:
+    // A capacidade é arredondada para uma potência de dois de páginas
+    explicit MirroredRingBuffer(size_t minCapacity) {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        bytes = page;
+        while (bytes < minCapacity * sizeof(T)) bytes <<= 1;
+
+        int fd = memfd_create("mirrored_ring", MFD_CLOEXEC);
+        if (fd < 0) throw std::bad_alloc();
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            close(fd);
+            throw std::bad_alloc();
+        }
+
+        // Reserva 2x o espaço de endereços e mapeia o mesmo arquivo nas duas metades
+        void* base = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            close(fd);
+            throw std::bad_alloc();
+        }
+
+        uint8_t* lower = static_cast<uint8_t*>(base);
+        void* first = mmap(lower, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+        void* second = mmap(lower + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+        close(fd); // Os mapeamentos mantêm o arquivo vivo
+
+        if (first == MAP_FAILED || second == MAP_FAILED) {
+            munmap(base, 2 * bytes);
+            throw std::bad_alloc();
+        }
+
+        data = static_cast<T*>(base);
+        slots = bytes / sizeof(T);
+        mask = slots - 1;
+    }
+
+    ~MirroredRingBuffer() {
+        if (data) munmap(data, 2 * bytes);
+    }
+
+    MirroredRingBuffer(const MirroredRingBuffer&) = delete;
+    MirroredRingBuffer& operator=(const MirroredRingBuffer&) = delete;
+
+    // Região gravável contígua de até n elementos
+    std::span<T> reserve(size_t n) {
+        uint64_t currentWrite = writeCount.load(std::memory_order_relaxed);
+        size_t count = std::min<size_t>(n, slots - (currentWrite - cachedReadCount));
+        if (count < n) {
+            cachedReadCount = readCount.load(std::memory_order_acquire);
+            count = std::min<size_t>(n, slots - (currentWrite - cachedReadCount));
+        }
+        return {data + (currentWrite & mask), count};
+    }
+
+    void commit(size_t n) {
+        writeCount.store(writeCount.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    // Região legível contígua de até n elementos
+    std::span<T> peek(size_t n) {
+        uint64_t currentRead = readCount.load(std::memory_order_relaxed);
+        size_t count = std::min<size_t>(n, cachedWriteCount - currentRead);
+        if (count < n) {
+            cachedWriteCount = writeCount.load(std::memory_order_acquire);
+            count = std::min<size_t>(n, cachedWriteCount - currentRead);
+        }
+        return {data + (currentRead & mask), count};
+    }
+
+    void release(size_t n) {
+        readCount.store(readCount.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    size_t push_n(std::span<const T> items) {
+        std::span<T> region = reserve(items.size());
+        if (region.empty()) return 0; // Nada a publicar: não toca o índice compartilhado
+        std::copy_n(items.begin(), region.size(), region.begin());
+        commit(region.size());
+        return region.size();
+    }
+
+    size_t pop_n(std::span<T> out) {
+        std::span<T> region = peek(out.size());
+        if (region.empty()) return 0; // Poll vazio: sem store no índice de leitura
+        std::copy(region.begin(), region.end(), out.begin());
+        release(region.size());
+        return region.size();
+    }
+
+    size_t write_available() const {
+        return slots - (writeCount.load(std::memory_order_relaxed) -
+                        readCount.load(std::memory_order_acquire));
+    }
+
+    size_t read_available() const {
+        return writeCount.load(std::memory_order_acquire) -
+               readCount.load(std::memory_order_relaxed);
+    }
+
+    bool isEmpty() const {
+        return readCount.load(std::memory_order_relaxed) == writeCount.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return slots; }
+};
+
+#endif // __linux__
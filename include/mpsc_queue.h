@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ring_buffer.h"
+
+// Fila bounded multi-produtor / consumidor único.
+// Cada slot carrega um número de sequência: produtores disputam a posição
+// de escrita via CAS e publicam o slot ao avançar sua sequência; o consumidor
+// apenas verifica a sequência do próximo slot, sem CAS nem laços de retry
+// (wait-free para a thread de áudio).
+template<typename T, size_t Capacity>
+class MPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity deve ser potência de dois");
+    static constexpr uint64_t kMask = Capacity - 1;
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+private:
+    alignas(kCacheLineSize) std::array<Slot, Capacity> slots;
+    alignas(kCacheLineSize) std::atomic<uint64_t> writePos{0};
+    alignas(kCacheLineSize) uint64_t readPos = 0;
+
+public:
+    MPSCQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Thread-safe entre produtores. Retorna false se a fila estiver cheia.
+    bool push(const T& item) {
+        uint64_t pos = writePos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Slot& slot = slots[pos & kMask];
+            uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+            if (diff == 0) {
+                // Slot livre nesta volta: tenta reivindicar a posição
+                if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = item;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // CAS falhou: pos já foi recarregado, tenta de novo
+            } else if (diff < 0) {
+                return false; // Fila cheia: consumidor ainda não liberou o slot
+            } else {
+                pos = writePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Apenas o consumidor. Nunca bloqueia nem repete.
+    bool pop(T& item) {
+        Slot& slot = slots[readPos & kMask];
+        if (slot.sequence.load(std::memory_order_acquire) != readPos + 1) {
+            return false; // Vazia, ou produtor ainda escrevendo este slot
+        }
+
+        item = slot.value;
+        slot.sequence.store(readPos + Capacity, std::memory_order_release);
+        ++readPos;
+        return true;
+    }
+
+    // Aproximado quando há produtores concorrentes
+    bool isEmpty() const {
+        return slots[readPos & kMask].sequence.load(std::memory_order_acquire) != readPos + 1;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+};
@@ -1,42 +1,488 @@
 #pragma once
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
 
-template<typename T, size_t Size>
+// Tamanho de linha de cache assumido para separar dados de produtor e consumidor
+inline constexpr size_t kCacheLineSize = 64;
+
+// Região contígua em até dois segmentos dentro do storage do ring
+// (o segundo só é não-vazio quando a região cruza o fim do array)
+template<typename T>
+struct RingRegion {
+    std::span<T> first;
+    std::span<T> second;
+
+    size_t size() const { return first.size() + second.size(); }
+    bool empty() const { return size() == 0; }
+};
+
+// Snapshot da saúde do ring desde a última leitura
+struct RingStats {
+    size_t minFill = 0;     // Menor ocupação observada pelo consumidor
+    size_t maxFill = 0;     // Maior ocupação observada pelo produtor
+    uint64_t overruns = 0;  // push/push_n que não couberam inteiros
+    uint64_t underruns = 0; // pop/pop_n que não encontraram dados suficientes
+};
+
+// Contadores opcionais de telemetria. Cada lado escreve apenas na sua própria
+// linha (separada das linhas de índice), então o thread de monitoramento pode
+// ler e zerar sem disputar as linhas do caminho crítico.
+// A ocupação é medida com o índice remoto em cache: o máximo é um limite
+// superior e o mínimo um limite inferior (ambos do lado seguro).
+class RingTelemetry {
+    alignas(kCacheLineSize) std::atomic<size_t> maxFill{0};
+    std::atomic<uint64_t> overruns{0};
+
+    alignas(kCacheLineSize) std::atomic<size_t> minFill{SIZE_MAX};
+    std::atomic<uint64_t> underruns{0};
+
+public:
+    void recordWrite(size_t fill) {
+        if (fill > maxFill.load(std::memory_order_relaxed)) maxFill.store(fill, std::memory_order_relaxed);
+    }
+    void recordRead(size_t fill) {
+        if (fill < minFill.load(std::memory_order_relaxed)) minFill.store(fill, std::memory_order_relaxed);
+    }
+    void recordOverrun() { overruns.fetch_add(1, std::memory_order_relaxed); }
+    void recordUnderrun() { underruns.fetch_add(1, std::memory_order_relaxed); }
+
+    // minFill fica em SIZE_MAX se não houve leituras desde o último reset
+    RingStats snapshot() const {
+        return {minFill.load(std::memory_order_relaxed), maxFill.load(std::memory_order_relaxed),
+                overruns.load(std::memory_order_relaxed), underruns.load(std::memory_order_relaxed)};
+    }
+
+    RingStats take() {
+        return {minFill.exchange(SIZE_MAX, std::memory_order_relaxed),
+                maxFill.exchange(0, std::memory_order_relaxed),
+                overruns.exchange(0, std::memory_order_relaxed),
+                underruns.exchange(0, std::memory_order_relaxed)};
+    }
+};
+
+// Versão vazia: sem custo quando a telemetria está desabilitada
+struct NoRingTelemetry {
+    void recordWrite(size_t) {}
+    void recordRead(size_t) {}
+    void recordOverrun() {}
+    void recordUnderrun() {}
+};
+
+template<bool Enabled>
+using RingTelemetryFor = std::conditional_t<Enabled, RingTelemetry, NoRingTelemetry>;
+
+// Flags de espera do lado não-real-time, em linha própria. O lado RT só lê
+// a flag do outro lado e chama notify quando alguém está de fato esperando.
+struct RingWaiters {
+    alignas(kCacheLineSize) std::atomic<uint32_t> producer{0};
+    std::atomic<uint32_t> consumer{0};
+};
+
+struct NoRingWaiters {};
+
+// Opções de compilação dos rings (combináveis com |)
+inline constexpr unsigned kRingTelemetry = 1u << 0; // Contadores de RingStats
+inline constexpr unsigned kRingBlocking = 1u << 1;  // push_wait/pop_wait
+
+template<typename T, size_t Size, unsigned Options = 0>
 class LockFreeRingBuffer {
+    static constexpr bool kTelemetry = (Options & kRingTelemetry) != 0;
+    static constexpr bool kBlocking = (Options & kRingBlocking) != 0;
+
 private:
-    std::array<T, Size> buffer;
-    std::atomic<size_t> writePos{0};
-    std::atomic<size_t> readPos{0};
+    alignas(kCacheLineSize) std::array<T, Size> buffer;
+
+    // Linha do produtor: índice publicado + cópia local do índice do consumidor
+    alignas(kCacheLineSize) std::atomic<size_t> writePos{0};
+    size_t cachedReadPos = 0;
+
+    // Linha do consumidor: índice publicado + cópia local do índice do produtor
+    alignas(kCacheLineSize) std::atomic<size_t> readPos{0};
+    size_t cachedWritePos = 0;
+
+    [[no_unique_address]] RingTelemetryFor<kTelemetry> telemetry;
+    [[no_unique_address]] std::conditional_t<kBlocking, RingWaiters, NoRingWaiters> waiters;
     
 public:
     bool push(const T& item) {
         size_t currentWrite = writePos.load(std::memory_order_relaxed);
         size_t nextWrite = (currentWrite + 1) % Size;
         
-        if (nextWrite == readPos.load(std::memory_order_acquire)) {
-            return false; // Buffer cheio
+        if (nextWrite == cachedReadPos) {
+            // Só recarrega o índice remoto quando o buffer parece cheio
+            cachedReadPos = readPos.load(std::memory_order_acquire);
+            if (nextWrite == cachedReadPos) {
+                telemetry.recordOverrun();
+                return false; // Buffer cheio
+            }
         }
         
         buffer[currentWrite] = item;
         writePos.store(nextWrite, std::memory_order_release);
+        telemetry.recordWrite(usedSlots(nextWrite, cachedReadPos));
+        wakeConsumer();
         return true;
     }
     
     bool pop(T& item) {
         size_t currentRead = readPos.load(std::memory_order_relaxed);
         
-        if (currentRead == writePos.load(std::memory_order_acquire)) {
-            return false; // Buffer vazio
+        if (currentRead == cachedWritePos) {
+            cachedWritePos = writePos.load(std::memory_order_acquire);
+            if (currentRead == cachedWritePos) {
+                telemetry.recordUnderrun();
+                return false; // Buffer vazio
+            }
         }
         
         item = buffer[currentRead];
-        readPos.store((currentRead + 1) % Size, std::memory_order_release);
+        size_t nextRead = (currentRead + 1) % Size;
+        readPos.store(nextRead, std::memory_order_release);
+        telemetry.recordRead(usedSlots(cachedWritePos, nextRead));
+        wakeProducer();
         return true;
     }
     
+    // Reserva até n slots para escrita direta no storage do ring.
+    // Os dados só ficam visíveis ao consumidor após commit().
+    RingRegion<T> reserve(size_t n) {
+        size_t currentWrite = writePos.load(std::memory_order_relaxed);
+        size_t count = std::min(n, freeSlots(currentWrite, cachedReadPos));
+        if (count < n) {
+            cachedReadPos = readPos.load(std::memory_order_acquire);
+            count = std::min(n, freeSlots(currentWrite, cachedReadPos));
+        }
+        return region(currentWrite, count);
+    }
+
+    // Publica n slots previamente reservados (n <= reserve().size())
+    void commit(size_t n) {
+        size_t nextWrite = (writePos.load(std::memory_order_relaxed) + n) % Size;
+        writePos.store(nextWrite, std::memory_order_release);
+        telemetry.recordWrite(usedSlots(nextWrite, cachedReadPos));
+        wakeConsumer();
+    }
+
+    // Expõe até n elementos prontos para processamento in-place
+    RingRegion<T> peek(size_t n) {
+        size_t currentRead = readPos.load(std::memory_order_relaxed);
+        size_t count = std::min(n, usedSlots(cachedWritePos, currentRead));
+        if (count < n) {
+            cachedWritePos = writePos.load(std::memory_order_acquire);
+            count = std::min(n, usedSlots(cachedWritePos, currentRead));
+        }
+        return region(currentRead, count);
+    }
+
+    // Devolve n elementos consumidos (n <= peek().size()) ao produtor
+    void release(size_t n) {
+        size_t nextRead = (readPos.load(std::memory_order_relaxed) + n) % Size;
+        readPos.store(nextRead, std::memory_order_release);
+        telemetry.recordRead(usedSlots(cachedWritePos, nextRead));
+        wakeProducer();
+    }
+
+    // Copia até items.size() elementos em no máximo dois segmentos contíguos
+    // e publica o índice uma única vez. Retorna quantos foram escritos.
+    size_t push_n(std::span<const T> items) {
+        RingRegion<T> r = reserve(items.size());
+        if (r.empty()) {
+            // Nada a publicar: não toca o índice compartilhado
+            if (!items.empty()) telemetry.recordOverrun();
+            return 0;
+        }
+        std::copy_n(items.begin(), r.first.size(), r.first.begin());
+        std::copy_n(items.begin() + r.first.size(), r.second.size(), r.second.begin());
+        commit(r.size());
+        if (r.size() < items.size()) telemetry.recordOverrun();
+        return r.size();
+    }
+
+    // Lê até out.size() elementos; retorna quantos foram lidos.
+    size_t pop_n(std::span<T> out) {
+        RingRegion<T> r = peek(out.size());
+        if (r.empty()) {
+            // Poll vazio: sem store no índice de leitura, que invalidaria a linha do produtor
+            if (!out.empty()) telemetry.recordUnderrun();
+            return 0;
+        }
+        std::copy(r.first.begin(), r.first.end(), out.begin());
+        std::copy(r.second.begin(), r.second.end(), out.begin() + r.first.size());
+        release(r.size());
+        if (r.size() < out.size()) telemetry.recordUnderrun();
+        return r.size();
+    }
+
+    // Espaço livre visto pelo produtor
+    size_t write_available() const {
+        return freeSlots(writePos.load(std::memory_order_relaxed),
+                         readPos.load(std::memory_order_acquire));
+    }
+
+    // Elementos prontos vistos pelo consumidor
+    size_t read_available() const {
+        return usedSlots(writePos.load(std::memory_order_acquire),
+                         readPos.load(std::memory_order_relaxed));
+    }
+
     bool isEmpty() const {
         return readPos.load(std::memory_order_relaxed) == writePos.load(std::memory_order_relaxed);
     }
+
+    // Leitura da telemetria pelo thread de monitoramento
+    RingStats stats() const requires kTelemetry { return telemetry.snapshot(); }
+    RingStats takeStats() requires kTelemetry { return telemetry.take(); }
+
+    // Push bloqueante, apenas para um produtor que NÃO seja o thread de áudio.
+    // Dorme (futex) até o consumidor liberar espaço.
+    void push_wait(const T& item) requires kBlocking {
+        while (!push(item)) {
+            size_t observedRead = cachedReadPos;
+            waiters.producer.store(1, std::memory_order_relaxed);
+            // Par com a fence de wakeProducer(): um dos lados vê o store do outro
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (readPos.load(std::memory_order_relaxed) == observedRead) {
+                readPos.wait(observedRead, std::memory_order_acquire);
+            }
+            waiters.producer.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Pop bloqueante, apenas para um consumidor que NÃO seja o thread de áudio.
+    void pop_wait(T& item) requires kBlocking {
+        while (!pop(item)) {
+            size_t observedWrite = cachedWritePos;
+            waiters.consumer.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (writePos.load(std::memory_order_relaxed) == observedWrite) {
+                writePos.wait(observedWrite, std::memory_order_acquire);
+            }
+            waiters.consumer.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Sem syscall no caso comum: notify só quando há alguém esperando
+    void wakeProducer() {
+        if constexpr (kBlocking) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.producer.load(std::memory_order_relaxed)) readPos.notify_one();
+        }
+    }
+
+    void wakeConsumer() {
+        if constexpr (kBlocking) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.consumer.load(std::memory_order_relaxed)) writePos.notify_one();
+        }
+    }
+
+    RingRegion<T> region(size_t start, size_t count) {
+        size_t first = std::min(count, Size - start);
+        return {std::span<T>(buffer.data() + start, first),
+                std::span<T>(buffer.data(), count - first)};
+    }
+
+    static size_t usedSlots(size_t write, size_t read) {
+        return (write + Size - read) % Size;
+    }
+
+    // Um slot fica sempre vazio para distinguir cheio de vazio
+    static size_t freeSlots(size_t write, size_t read) {
+        return Size - 1 - usedSlots(write, read);
+    }
+};
+
+// Variante com capacidade potência de dois: contadores de 64 bits livres
+// (nunca reiniciam) e indexação por máscara. Sem divisão no caminho crítico
+// e todos os Capacity slots são utilizáveis, pois cheio/vazio é decidido
+// pela diferença entre os contadores.
+template<typename T, size_t Capacity, unsigned Options = 0>
+class PowerOfTwoRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity deve ser potência de dois");
+    static constexpr uint64_t kMask = Capacity - 1;
+    static constexpr bool kTelemetry = (Options & kRingTelemetry) != 0;
+    static constexpr bool kBlocking = (Options & kRingBlocking) != 0;
+
+private:
+    alignas(kCacheLineSize) std::array<T, Capacity> buffer;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeCount{0};
+    uint64_t cachedReadCount = 0;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> readCount{0};
+    uint64_t cachedWriteCount = 0;
+
+    [[no_unique_address]] RingTelemetryFor<kTelemetry> telemetry;
+    [[no_unique_address]] std::conditional_t<kBlocking, RingWaiters, NoRingWaiters> waiters;
+
+public:
+    bool push(const T& item) {
+        uint64_t currentWrite = writeCount.load(std::memory_order_relaxed);
+
+        if (currentWrite - cachedReadCount == Capacity) {
+            cachedReadCount = readCount.load(std::memory_order_acquire);
+            if (currentWrite - cachedReadCount == Capacity) {
+                telemetry.recordOverrun();
+                return false; // Buffer cheio
+            }
+        }
+
+        buffer[currentWrite & kMask] = item;
+        writeCount.store(currentWrite + 1, std::memory_order_release);
+        telemetry.recordWrite(currentWrite + 1 - cachedReadCount);
+        wakeConsumer();
+        return true;
+    }
+
+    bool pop(T& item) {
+        uint64_t currentRead = readCount.load(std::memory_order_relaxed);
+
+        if (currentRead == cachedWriteCount) {
+            cachedWriteCount = writeCount.load(std::memory_order_acquire);
+            if (currentRead == cachedWriteCount) {
+                telemetry.recordUnderrun();
+                return false; // Buffer vazio
+            }
+        }
+
+        item = buffer[currentRead & kMask];
+        readCount.store(currentRead + 1, std::memory_order_release);
+        telemetry.recordRead(cachedWriteCount - (currentRead + 1));
+        wakeProducer();
+        return true;
+    }
+
+    RingRegion<T> reserve(size_t n) {
+        uint64_t currentWrite = writeCount.load(std::memory_order_relaxed);
+        size_t count = std::min<size_t>(n, Capacity - (currentWrite - cachedReadCount));
+        if (count < n) {
+            cachedReadCount = readCount.load(std::memory_order_acquire);
+            count = std::min<size_t>(n, Capacity - (currentWrite - cachedReadCount));
+        }
+        return region(currentWrite, count);
+    }
+
+    void commit(size_t n) {
+        uint64_t nextWrite = writeCount.load(std::memory_order_relaxed) + n;
+        writeCount.store(nextWrite, std::memory_order_release);
+        telemetry.recordWrite(nextWrite - cachedReadCount);
+        wakeConsumer();
+    }
+
+    RingRegion<T> peek(size_t n) {
+        uint64_t currentRead = readCount.load(std::memory_order_relaxed);
+        size_t count = std::min<size_t>(n, cachedWriteCount - currentRead);
+        if (count < n) {
+            cachedWriteCount = writeCount.load(std::memory_order_acquire);
+            count = std::min<size_t>(n, cachedWriteCount - currentRead);
+        }
+        return region(currentRead, count);
+    }
+
+    void release(size_t n) {
+        uint64_t nextRead = readCount.load(std::memory_order_relaxed) + n;
+        readCount.store(nextRead, std::memory_order_release);
+        telemetry.recordRead(cachedWriteCount - nextRead);
+        wakeProducer();
+    }
+
+    size_t push_n(std::span<const T> items) {
+        RingRegion<T> r = reserve(items.size());
+        if (r.empty()) {
+            // Nada a publicar: não toca o índice compartilhado
+            if (!items.empty()) telemetry.recordOverrun();
+            return 0;
+        }
+        std::copy_n(items.begin(), r.first.size(), r.first.begin());
+        std::copy_n(items.begin() + r.first.size(), r.second.size(), r.second.begin());
+        commit(r.size());
+        if (r.size() < items.size()) telemetry.recordOverrun();
+        return r.size();
+    }
+
+    size_t pop_n(std::span<T> out) {
+        RingRegion<T> r = peek(out.size());
+        if (r.empty()) {
+            // Poll vazio: sem store no índice de leitura, que invalidaria a linha do produtor
+            if (!out.empty()) telemetry.recordUnderrun();
+            return 0;
+        }
+        std::copy(r.first.begin(), r.first.end(), out.begin());
+        std::copy(r.second.begin(), r.second.end(), out.begin() + r.first.size());
+        release(r.size());
+        if (r.size() < out.size()) telemetry.recordUnderrun();
+        return r.size();
+    }
+
+    size_t write_available() const {
+        return Capacity - (writeCount.load(std::memory_order_relaxed) -
+                           readCount.load(std::memory_order_acquire));
+    }
+
+    size_t read_available() const {
+        return writeCount.load(std::memory_order_acquire) -
+               readCount.load(std::memory_order_relaxed);
+    }
+
+    bool isEmpty() const {
+        return readCount.load(std::memory_order_relaxed) == writeCount.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    RingStats stats() const requires kTelemetry { return telemetry.snapshot(); }
+    RingStats takeStats() requires kTelemetry { return telemetry.take(); }
+
+    void push_wait(const T& item) requires kBlocking {
+        while (!push(item)) {
+            uint64_t observedRead = cachedReadCount;
+            waiters.producer.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (readCount.load(std::memory_order_relaxed) == observedRead) {
+                readCount.wait(observedRead, std::memory_order_acquire);
+            }
+            waiters.producer.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void pop_wait(T& item) requires kBlocking {
+        while (!pop(item)) {
+            uint64_t observedWrite = cachedWriteCount;
+            waiters.consumer.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (writeCount.load(std::memory_order_relaxed) == observedWrite) {
+                writeCount.wait(observedWrite, std::memory_order_acquire);
+            }
+            waiters.consumer.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    void wakeProducer() {
+        if constexpr (kBlocking) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.producer.load(std::memory_order_relaxed)) readCount.notify_one();
+        }
+    }
+
+    void wakeConsumer() {
+        if constexpr (kBlocking) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.consumer.load(std::memory_order_relaxed)) writeCount.notify_one();
+        }
+    }
+
+    RingRegion<T> region(uint64_t counter, size_t count) {
+        size_t start = counter & kMask;
+        size_t first = std::min(count, Capacity - start);
+        return {std::span<T>(buffer.data() + start, first),
+                std::span<T>(buffer.data(), count - first)};
+    }
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+// Armadilha de alocação para o thread de áudio (builds de debug/benchmark).
+// Com MIXER_RT_ALLOC_GUARD definido e src/rt_alloc_guard.cpp linkado, os
+// operator new/delete globais são substituídos e malloc/free são
+// interceptados (glibc). Toda chamada ao alocador feita dentro de um RtScope
+// é contada; no modo Abort o processo aborta com backtrace na hora, apontando
+// a linha culpada. Sem a flag, RtScope não custa nada e as contagens são zero.
+enum class RtAllocMode {
+    Count, // Apenas conta (padrão)
+    Abort  // Aborta com backtrace na primeira violação
+};
+
+struct RtAllocStats {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+};
+
+#ifdef MIXER_RT_ALLOC_GUARD
+inline constexpr bool kRtAllocGuard = true;
+
+void rtScopeEnter();
+void rtScopeExit();
+bool inRtScope();
+
+// Totais de todos os threads desde o início do processo
+RtAllocStats rtAllocStats();
+
+// Retorna o modo anterior. O modo inicial também pode vir do ambiente:
+// MIXER_RT_ALLOC_STRICT=1
+RtAllocMode setRtAllocMode(RtAllocMode mode);
+#else
+inline constexpr bool kRtAllocGuard = false;
+
+inline void rtScopeEnter() {}
+inline void rtScopeExit() {}
+inline bool inRtScope() { return false; }
+inline RtAllocStats rtAllocStats() { return {}; }
+inline RtAllocMode setRtAllocMode(RtAllocMode) { return RtAllocMode::Count; }
+#endif
+
+// Marca o trecho do thread atual que não pode tocar o alocador (aninhável)
+class RtScope {
+public:
+    RtScope() { rtScopeEnter(); }
+    ~RtScope() { rtScopeExit(); }
+
+    RtScope(const RtScope&) = delete;
+    RtScope& operator=(const RtScope&) = delete;
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "memory_arena.h"
+
+// Bloco estático de N bytes alinhado para uma StaticArena. Declarado sem
+// inicializador, vai zerado para o .bss.
+template<size_t N>
+struct alignas(kArenaAlignment) StaticArenaStorage {
+    static_assert(N > 0, "StaticArena precisa de capacidade");
+    uint8_t bytes[N];
+};
+
+// MemoryArena sobre storage estático, para builds que precisam partir sem
+// nenhuma chamada ao heap:
+//
+//     constinit StaticArenaStorage<10 * 1024 * 1024> engineStorage;
+//     constinit StaticArena<engineStorage> engineArena;
+//
+// Cada arena nomeia o seu próprio storage, então duas arenas do mesmo tamanho
+// nunca compartilham memória. Só o cabeçalho da arena, de poucos bytes, fica
+// no .data. Como é uma MemoryArena, funciona com ArenaScope, BlockPool,
+// ArenaResource etc.
+template<auto& Storage>
+class StaticArena : public MemoryArena {
+public:
+    constexpr StaticArena() : MemoryArena(Storage.bytes, sizeof(Storage.bytes)) {}
+};
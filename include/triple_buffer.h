@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "ring_buffer.h"
+
+// Canal "o mais recente vence" entre um escritor (thread de áudio) e um
+// leitor (UI / monitoramento). Três slots: o escritor preenche o seu, o
+// leitor mantém o seu estável, e o do meio é trocado atomicamente.
+// Ambos os lados são wait-free: publish() nunca falha e o leitor sempre
+// obtém o snapshot completo mais novo, sem drenar entradas antigas.
+template<typename T>
+class TripleBuffer {
+    // Bit sinalizando que o slot do meio tem dados que o leitor ainda não viu
+    static constexpr uint8_t kFresh = 0x4;
+    static constexpr uint8_t kIndexMask = 0x3;
+
+    struct alignas(kCacheLineSize) Slot {
+        T value{};
+    };
+
+private:
+    std::array<Slot, 3> slots;
+
+    alignas(kCacheLineSize) std::atomic<uint8_t> middle{1};
+    alignas(kCacheLineSize) uint8_t back = 0;  // Do escritor
+    alignas(kCacheLineSize) uint8_t front = 2; // Do leitor
+
+public:
+    // Apenas o escritor: slot privado para preencher in-place
+    T& writeBuffer() { return slots[back].value; }
+
+    // Apenas o escritor: torna o slot preenchido o snapshot mais recente
+    void publish() {
+        uint8_t previous = middle.exchange(back | kFresh, std::memory_order_acq_rel);
+        back = previous & kIndexMask;
+    }
+
+    void write(const T& value) {
+        writeBuffer() = value;
+        publish();
+    }
+
+    // Apenas o leitor: troca para o snapshot mais novo, se houver.
+    // Retorna true quando o conteúdo de read() mudou.
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & kIndexMask;
+        return true;
+    }
+
+    // Apenas o leitor: snapshot atual (estável até o próximo update())
+    const T& read() const { return slots[front].value; }
+};
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include "memory_arena.h"
+#include "rt_alloc_guard.h"
 #include "audio_nodes.h"
 #include "wav_io.h"
 
@@ -21,25 +22,34 @@ public:
     }
 
     void process(float g1, float g2) {
-        // Alocação Zero: Objetos criados na stack ou pré-alocados
-        GainNode gainNode1(g1);
-        GainNode gainNode2(g2);
-        MixerNode mixer;
-
-        AudioBuffer b1(buffer1.data(), buffer1.size());
-        AudioBuffer b2(buffer2.data(), buffer2.size());
-        AudioBuffer out(outputBuffer.data(), outputBuffer.size());
-
-        gainNode1.process(b1);
-        gainNode2.process(b2);
-        mixer.mix(b1, b2, out);
-        
+        {
+            // Alocação Zero: Objetos criados na stack ou pré-alocados
+            RtScope rt;
+            GainNode gainNode1(g1);
+            GainNode gainNode2(g2);
+            MixerNode mixer;
+
+            AudioBuffer b1(buffer1.data(), buffer1.size());
+            AudioBuffer b2(buffer2.data(), buffer2.size());
+            AudioBuffer out(outputBuffer.data(), outputBuffer.size());
+
+            gainNode1.process(b1);
+            gainNode2.process(b2);
+            mixer.mix(b1, b2, out);
+        }
+
+        // Log fora do RtScope: std::cout pode alocar
         std::cout << "[Engine] Processamento concluído. Memória de Arena usada: " << arena.used() << " bytes.\n";
     }
 
     bool save(const char* out) {
         return WavReader::write(out, outputBuffer, sampleRate, channels);
     }
+
+    // Pico de uso e contabilidade por tag, para dimensionar a arena
+    void printArenaStats() const {
+        std::cout << arena.stats();
+    }
 };
 
 int main(int argc, char* argv[]) {
@@ -56,5 +66,6 @@ int main(int argc, char* argv[]) {
 
     engine.process(0.8f, 0.6f);
     engine.save(argv[3]);
+    engine.printArenaStats();
     return 0;
 }
\ No newline at end of file
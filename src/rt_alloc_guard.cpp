@@ -0,0 +1,197 @@
+#include "rt_alloc_guard.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <unistd.h>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define MIXER_HAS_BACKTRACE 1
+#endif
+
+// Substitui o alocador global para flagrar alocações dentro de RtScope.
+// Compilado apenas nos builds com MIXER_RT_ALLOC_GUARD (ver CMakeLists.txt).
+
+#ifdef __GLIBC__
+// Ponto de entrada real do malloc da glibc, para não recursar nas versões
+// interceptadas abaixo
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+#endif
+
+namespace {
+
+// Estado inicializado de forma constante: acessá-lo de dentro do malloc não
+// dispara nenhuma inicialização dinâmica
+constinit thread_local unsigned rtDepth = 0;
+
+std::atomic<uint64_t> allocationCount{0};
+std::atomic<uint64_t> deallocationCount{0};
+
+RtAllocMode initialMode() {
+    const char* strict = std::getenv("MIXER_RT_ALLOC_STRICT");
+    return strict && *strict && *strict != '0' ? RtAllocMode::Abort : RtAllocMode::Count;
+}
+
+std::atomic<RtAllocMode> mode{initialMode()};
+
+[[noreturn]] void trap(const char* what, size_t size) {
+    // O próprio relatório pode alocar (backtrace carrega a libgcc na 1ª vez)
+    rtDepth = 0;
+
+    char message[128];
+    int length = std::snprintf(message, sizeof(message),
+                               "[RtAllocGuard] %s(%zu) dentro de RtScope\n", what, size);
+    if (length > 0) (void)!write(STDERR_FILENO, message, static_cast<size_t>(length));
+
+#ifdef MIXER_HAS_BACKTRACE
+    void* frames[64];
+    int count = backtrace(frames, 64);
+    backtrace_symbols_fd(frames, count, STDERR_FILENO);
+#endif
+    std::abort();
+}
+
+inline void checkAllocation(const char* what, size_t size) {
+    if (rtDepth == 0) [[likely]] return;
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (mode.load(std::memory_order_relaxed) == RtAllocMode::Abort) trap(what, size);
+}
+
+inline void checkDeallocation(const char* what, void* ptr) {
+    if (rtDepth == 0 || !ptr) [[likely]] return;
+    deallocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (mode.load(std::memory_order_relaxed) == RtAllocMode::Abort) trap(what, 0);
+}
+
+#ifdef __GLIBC__
+inline void* rawMalloc(size_t size) { return __libc_malloc(size); }
+inline void* rawAlignedMalloc(size_t alignment, size_t size) { return __libc_memalign(alignment, size); }
+inline void rawFree(void* ptr) { __libc_free(ptr); }
+#else
+inline void* rawMalloc(size_t size) { return std::malloc(size); }
+inline void* rawAlignedMalloc(size_t alignment, size_t size) {
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+inline void rawFree(void* ptr) { std::free(ptr); }
+#endif
+
+void* newImpl(size_t size) {
+    checkAllocation("operator new", size);
+    void* ptr = rawMalloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* newAlignedImpl(size_t size, std::align_val_t alignment) {
+    checkAllocation("operator new", size);
+    void* ptr = rawAlignedMalloc(static_cast<size_t>(alignment), size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void deleteImpl(void* ptr) {
+    checkDeallocation("operator delete", ptr);
+    rawFree(ptr);
+}
+
+} // namespace
+
+void rtScopeEnter() { ++rtDepth; }
+void rtScopeExit() { --rtDepth; }
+bool inRtScope() { return rtDepth != 0; }
+
+RtAllocStats rtAllocStats() {
+    return {allocationCount.load(std::memory_order_relaxed),
+            deallocationCount.load(std::memory_order_relaxed)};
+}
+
+RtAllocMode setRtAllocMode(RtAllocMode newMode) {
+    return mode.exchange(newMode, std::memory_order_relaxed);
+}
+
+// --- operator new/delete globais ---
+
+void* operator new(size_t size) { return newImpl(size); }
+void* operator new[](size_t size) { return newImpl(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return newAlignedImpl(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return newAlignedImpl(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return newImpl(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return newImpl(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return newAlignedImpl(size, alignment); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return newAlignedImpl(size, alignment); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { deleteImpl(ptr); }
+void operator delete[](void* ptr) noexcept { deleteImpl(ptr); }
+void operator delete(void* ptr, size_t) noexcept { deleteImpl(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { deleteImpl(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deleteImpl(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deleteImpl(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { deleteImpl(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { deleteImpl(ptr); }
+
+// --- malloc e família (interposição suportada pela glibc) ---
+
+#ifdef __GLIBC__
+extern "C" {
+
+void* malloc(size_t size) {
+    checkAllocation("malloc", size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    checkAllocation("calloc", count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    checkAllocation("realloc", size);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    checkAllocation("memalign", size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    checkAllocation("aligned_alloc", size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    checkAllocation("posix_memalign", size);
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+void free(void* ptr) {
+    checkDeallocation("free", ptr);
+    __libc_free(ptr);
+}
+
+} // extern "C"
+#endif
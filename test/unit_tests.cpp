@@ -1,11 +1,30 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
 #include <thread>
 #include <vector>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
 
 #include "memory_arena.h"
 #include "ring_buffer.h"
+#include "mpsc_queue.h"
+#include "broadcast_ring.h"
+#include "mirrored_ring_buffer.h"
+#include "message_ring.h"
+#include "triple_buffer.h"
+#include "deferred_reclaim.h"
+#include "arena_ring_buffer.h"
+#include "block_pool.h"
+#include "arena_resource.h"
+#include "arena_group.h"
+#include "double_buffered_arena.h"
+#include "chained_arena.h"
+#include "static_arena.h"
+#include "rt_alloc_guard.h"
 #include "audio_nodes/gain_node.h"
 #include "audio_nodes/mixer_node.h"
 #include "audio_nodes/fade_node.h"
@@ -59,6 +78,712 @@ TEST(MemoryArenaTest, OutOfMemoryException) {
     EXPECT_THROW(arena.allocate(200), std::bad_alloc);
 }
 
+TEST(MemoryArenaTest, WideAlignmentUsesRealAddress) {
+    MemoryArena arena(4096);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.allocate(1)) % kArenaAlignment, 0);
+
+    // Alinhamentos de AVX (32) e AVX-512 / linha de cache (64)
+    for (size_t alignment : {32, 64, 128}) {
+        arena.allocate(3);
+        void* ptr = arena.allocate(64, alignment);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+    }
+}
+
+TEST(MemoryArenaTest, StatsTrackHighWaterAndTags) {
+    MemoryArena arena(1024);
+    enum : uint8_t { kGainTag = 1, kMixerTag = 2 };
+
+    {
+        ArenaTagScope tag(arena, kGainTag);
+        arena.allocate(100);
+        arena.allocate(1, 1);
+    }
+    {
+        ArenaTagScope tag(arena, kMixerTag);
+        arena.allocate(64, 64); // Gera padding após os 101 bytes
+    }
+    EXPECT_EQ(arena.tryAllocate(4096), nullptr);
+
+    ArenaStats s = arena.stats();
+    EXPECT_EQ(s.allocations, 3);
+    EXPECT_EQ(s.failedAllocations, 1);
+    EXPECT_EQ(s.paddingBytes, 128 - 101);
+    EXPECT_EQ(s.highWater, 192);
+    EXPECT_EQ(s.tags[kGainTag].bytes, 101);
+    EXPECT_EQ(s.tags[kGainTag].allocations, 2);
+    EXPECT_EQ(s.tags[kMixerTag].bytes, 64);
+
+    // O pico sobrevive ao reset
+    arena.reset();
+    arena.allocate(10);
+    s = arena.stats();
+    EXPECT_EQ(s.used, 10);
+    EXPECT_EQ(s.highWater, 192);
+    EXPECT_EQ(s.resets, 1);
+    EXPECT_EQ(s.tags[kGainTag].bytes, 0);
+    EXPECT_EQ(s.tags[0].bytes, 10);
+}
+
+TEST(MemoryArenaTest, EmplaceRunsDestructorsInReverseOrder) {
+    struct Node {
+        std::vector<int>* log;
+        int id;
+        Node(std::vector<int>* l, int i) : log(l), id(i) {}
+        ~Node() { log->push_back(id); }
+    };
+    std::vector<int> log;
+
+    {
+        MemoryArena arena(1024);
+        arena.emplace<Node>(&log, 1);
+        arena.emplace<Node>(&log, 2);
+        arena.reset();
+        EXPECT_EQ(log, (std::vector<int>{2, 1}));
+
+        arena.emplace<Node>(&log, 3);
+        ArenaMarker m = arena.mark();
+        arena.emplace<Node>(&log, 4);
+        arena.emplace<Node>(&log, 5);
+        arena.rewind(m);
+        EXPECT_EQ(log, (std::vector<int>{2, 1, 5, 4}));
+    }
+    // A destruição da arena finaliza o que restou
+    EXPECT_EQ(log, (std::vector<int>{2, 1, 5, 4, 3}));
+}
+
+TEST(MemoryArenaTest, TrivialEmplaceHasNoOverhead) {
+    struct Plain { float gain; int id; };
+    static_assert(std::is_trivially_destructible_v<Plain>);
+
+    MemoryArena arena(1024);
+    arena.emplace<Plain>(Plain{1.0f, 1});
+    EXPECT_EQ(arena.used(), sizeof(Plain));
+    EXPECT_EQ(arena.stats().allocations, 1);
+}
+
+TEST(MemoryArenaTest, ScopeRewindsScratchAllocations) {
+    MemoryArena arena(1024);
+    void* persistent = arena.allocate(100);
+    size_t usedBefore = arena.used();
+
+    {
+        ArenaScope scope(arena);
+        arena.allocate(300);
+        arena.allocate(200);
+        EXPECT_GT(arena.used(), usedBefore);
+    }
+    EXPECT_EQ(arena.used(), usedBefore);
+
+    // Markers explícitos também funcionam aninhados
+    ArenaMarker outer = arena.mark();
+    arena.allocate(50);
+    ArenaMarker inner = arena.mark();
+    arena.allocate(50);
+    arena.rewind(inner);
+    EXPECT_EQ(arena.used(), inner.offset);
+    arena.rewind(outer);
+    EXPECT_EQ(arena.used(), usedBefore);
+    EXPECT_NE(persistent, nullptr);
+}
+
+TEST(MemoryArenaTest, ScopeEndingAfterInnerResetIsNoOp) {
+    MemoryArena arena(4096);
+    {
+        ArenaScope scope(arena);
+        arena.emplace<std::string>("um texto longo o bastante para ir ao heap");
+        arena.reset();
+        std::string* kept = arena.emplace<std::string>("criado depois do reset");
+        EXPECT_EQ(*kept, "criado depois do reset");
+    } // O marcador do escopo é anterior ao reset(): nada a desfazer
+
+    EXPECT_GT(arena.used(), 0u);
+
+    // Marcador além da posição atual também é ignorado
+    ArenaMarker ahead = arena.mark();
+    ahead.offset += 1024;
+    size_t used = arena.used();
+    arena.rewind(ahead);
+    EXPECT_EQ(arena.used(), used);
+}
+
+// Registra em ordem os ids destruídos
+struct IdTracked {
+    std::vector<int>* log;
+    int id;
+    ~IdTracked() { log->push_back(id); }
+};
+
+TEST(MemoryArenaTest, RewindPastEarlierRewindKeepsOlderObjects) {
+    std::vector<int> destroyed;
+    MemoryArena arena(4096);
+    arena.emplace<IdTracked>(&destroyed, 1);
+
+    ArenaMarker m0 = arena.mark();
+    arena.emplace<IdTracked>(&destroyed, 2);
+    ArenaMarker m1 = arena.mark();
+    arena.rewind(m0);
+    EXPECT_EQ(destroyed, std::vector<int>({2}));
+
+    // O nó de m1 já não existe; a nova alocação passa do seu offset
+    arena.allocate(64);
+    arena.emplace<IdTracked>(&destroyed, 3);
+    ASSERT_GT(arena.used(), m1.offset);
+    arena.rewind(m1);
+
+    // Só o que termina além de m1 é destruído; 1 continua vivo
+    EXPECT_EQ(destroyed, std::vector<int>({2, 3}));
+    EXPECT_EQ(arena.used(), m1.offset);
+    arena.reset();
+    EXPECT_EQ(destroyed, std::vector<int>({2, 3, 1}));
+}
+
+TEST(MemoryArenaTest, HugeRequestFailsInsteadOfWrapping) {
+    MemoryArena arena(1024);
+    arena.allocate(16);
+    EXPECT_EQ(arena.tryAllocate(SIZE_MAX - 8, 1), nullptr);
+    EXPECT_EQ(arena.tryAllocate(SIZE_MAX, 64), nullptr);
+    EXPECT_EQ(arena.used(), 16u);
+
+    // Mesmo caminho via ArenaResource, que repassa qualquer tamanho
+    ArenaResource resource(arena, ArenaFailure::Throw);
+    EXPECT_THROW((void)resource.allocate(SIZE_MAX - 8, 1), std::bad_alloc);
+    EXPECT_EQ(arena.used(), 16u);
+}
+
+TEST(MemoryArenaTest, CarvedScratchRegionIsIndependent) {
+    MemoryArena arena(4096);
+    MemoryArena scratch = arena.carveScratch(1024);
+    size_t persistentUsed = arena.used();
+    EXPECT_EQ(scratch.capacity(), 1024);
+
+    void* work = scratch.allocate(512, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(work) % 64, 0);
+    scratch.reset();
+    EXPECT_EQ(scratch.used(), 0);
+    EXPECT_EQ(arena.used(), persistentUsed);
+    EXPECT_THROW(scratch.allocate(2048), std::bad_alloc);
+}
+
+#ifdef __linux__
+TEST(MemoryArenaTest, PrefaultedArenaTakesNoMinorFaults) {
+    constexpr size_t kSize = 8 * 1024 * 1024;
+    MemoryArena arena(kSize, {.prefault = true, .lockPages = true});
+
+    // Toca a arena inteira: nenhuma página nova deve ser mapeada
+    long before = currentMinorFaults();
+    uint8_t* data = static_cast<uint8_t*>(arena.allocate(kSize, 64));
+    for (size_t i = 0; i < kSize; i += 64) data[i] = static_cast<uint8_t>(i);
+    long after = currentMinorFaults();
+
+    EXPECT_EQ(after - before, 0);
+}
+#endif
+
+#ifdef __linux__
+// THP disponível no sistema (modo "always" ou "madvise")
+static bool transparentHugePagesAvailable() {
+    FILE* f = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (!f) return false;
+    char mode[128] = {};
+    bool available = std::fgets(mode, sizeof(mode), f) && !std::strstr(mode, "[never]");
+    std::fclose(f);
+    return available;
+}
+
+TEST(MemoryArenaTest, PrefaultedTransparentHugePages) {
+    if (!transparentHugePagesAvailable()) GTEST_SKIP() << "THP desabilitado no sistema";
+
+    constexpr size_t kSize = 8 * 1024 * 1024;
+    MemoryArena arena(kSize, {.pages = ArenaPages::TransparentHuge, .prefault = true});
+
+    // O prefault precisa acontecer depois do madvise, senão as páginas são de 4 KB
+    EXPECT_TRUE(arena.usesHugePages());
+
+    long before = currentMinorFaults();
+    uint8_t* data = static_cast<uint8_t*>(arena.allocate(kSize, 64));
+    for (size_t i = 0; i < kSize; i += 4096) data[i] = static_cast<uint8_t>(i);
+    EXPECT_EQ(currentMinorFaults() - before, 0);
+}
+#endif
+
+TEST(MemoryArenaTest, TransparentHugePagesOption) {
+    MemoryArena arena(4 * 1024 * 1024, {.pages = ArenaPages::TransparentHuge});
+    EXPECT_EQ(arena.capacity(), 4 * 1024 * 1024);
+
+    // Com ou sem THP disponível, a arena deve funcionar normalmente
+    float* data = static_cast<float*>(arena.allocate(1024 * sizeof(float), 64));
+    data[0] = 1.0f;
+    data[1023] = 2.0f;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % 64, 0);
+    EXPECT_FLOAT_EQ(data[0] + data[1023], 3.0f);
+}
+
+TEST(BlockPoolTest, AllocatesAlignedBlocksUntilExhausted) {
+    MemoryArena arena(8192);
+    BlockPool pool(arena, 100, 8);
+    EXPECT_EQ(pool.blockSize(), 128);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        void* b = pool.allocate();
+        ASSERT_NE(b, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0);
+        EXPECT_TRUE(pool.owns(b));
+        blocks.push_back(b);
+    }
+    EXPECT_EQ(pool.allocate(), nullptr);
+
+    // Devolução individual e reuso imediato
+    pool.deallocate(blocks[3]);
+    EXPECT_EQ(pool.allocate(), blocks[3]);
+}
+
+TEST(BlockPoolTest, RemoteFreesFromDecoderThread) {
+    MemoryArena arena(64 * 1024);
+    BlockPool pool(arena, 256, 64);
+    LockFreeRingBuffer<void*, 128> toDecoder;
+    constexpr int kRounds = 20000;
+
+    // O thread de áudio aloca; o decoder devolve concorrentemente
+    std::atomic<bool> done{false};
+    std::thread decoder([&] {
+        void* block;
+        while (!done.load() || !toDecoder.isEmpty()) {
+            if (toDecoder.pop(block)) pool.deallocateRemote(block);
+            else std::this_thread::yield();
+        }
+    });
+
+    for (int i = 0; i < kRounds; ++i) {
+        void* block;
+        while (!(block = pool.allocate())) std::this_thread::yield();
+        static_cast<int*>(block)[0] = i;
+        while (!toDecoder.push(block)) std::this_thread::yield();
+    }
+    done.store(true);
+    decoder.join();
+
+    // Todos os blocos voltaram ao pool
+    int available = 0;
+    while (pool.allocate()) ++available;
+    EXPECT_EQ(available, 64);
+}
+
+TEST(ArenaResourceTest, PmrVectorAllocatesFromArena) {
+    MemoryArena arena(64 * 1024);
+    ArenaResource resource(arena);
+
+    std::pmr::vector<float> samples(&resource);
+    samples.resize(1024, 1.0f);
+
+    EXPECT_TRUE(arena.owns(samples.data()));
+    EXPECT_GE(arena.used(), 1024 * sizeof(float));
+}
+
+TEST(ArenaResourceTest, FailurePolicies) {
+    MemoryArena arena(256);
+    ArenaResource throwing(arena, ArenaFailure::Throw);
+    EXPECT_THROW((void)throwing.allocate(1024), std::bad_alloc);
+
+    // Upstream só para uso fora do RT (renderização offline, testes)
+    ArenaResource fallback(arena, ArenaFailure::Upstream, std::pmr::new_delete_resource());
+    void* p = fallback.allocate(1024);
+    EXPECT_FALSE(arena.owns(p));
+    fallback.deallocate(p, 1024);
+
+    ArenaResource aborting(arena);
+    EXPECT_DEATH((void)aborting.allocate(1024), "esgotada");
+}
+
+TEST(ArenaResourceTest, PoolResourceRecyclesBlocks) {
+    MemoryArena arena(8192);
+    BlockPool pool(arena, 64, 4);
+    PoolResource resource(pool, ArenaFailure::Throw);
+
+    void* a = resource.allocate(48);
+    EXPECT_TRUE(pool.owns(a));
+    resource.deallocate(a, 48);
+    EXPECT_EQ(resource.allocate(32), a);
+    EXPECT_THROW((void)resource.allocate(128), std::bad_alloc);
+}
+
+TEST(ArenaGroupTest, EachWorkerGetsItsOwnArena) {
+    constexpr size_t kWorkers = 4;
+    ArenaGroup group(kWorkers, 4096);
+
+    std::vector<MemoryArena*> seen(kWorkers, nullptr);
+    std::vector<std::thread> threads;
+    std::atomic<size_t> bound{0};
+    for (size_t w = 0; w < kWorkers; ++w) {
+        threads.emplace_back([&, w] {
+            MemoryArena& arena = group.local();
+            EXPECT_EQ(&arena, &group.local()); // Associação estável
+            for (int i = 0; i < 10; ++i) arena.allocate(100, 64);
+            seen[w] = &arena;
+
+            // Todos vivos ao mesmo tempo: quem sai devolve a sub-arena
+            bound.fetch_add(1);
+            while (bound.load() < kWorkers) std::this_thread::yield();
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    for (size_t a = 0; a < kWorkers; ++a) {
+        for (size_t b = a + 1; b < kWorkers; ++b) EXPECT_NE(seen[a], seen[b]);
+    }
+
+    // Sub-arenas começam em linhas de cache distintas
+    for (size_t w = 0; w < kWorkers; ++w) {
+        MemoryArena& arena = group.worker(w);
+        arena.reset();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.allocate(1, 1)) % kArenaAlignment, 0);
+    }
+
+    ArenaStats total = group.stats();
+    EXPECT_EQ(total.capacity, kWorkers * 4096);
+    EXPECT_EQ(total.allocations, kWorkers * 11);
+    EXPECT_EQ(total.highWater, kWorkers * (9 * 128 + 100));
+}
+
+TEST(ArenaGroupTest, ExitedThreadsReleaseTheirArena) {
+    ArenaGroup group(1, 1024);
+
+    // Threads novos a cada job: cada um reutiliza a sub-arena do anterior
+    MemoryArena* first = nullptr;
+    for (int job = 0; job < 8; ++job) {
+        std::thread worker([&] {
+            MemoryArena& arena = group.local();
+            if (!first) first = &arena;
+            EXPECT_EQ(&arena, first);
+        });
+        worker.join();
+    }
+
+    // Enquanto um thread vivo a possui, não há sub-arena livre
+    std::atomic<bool> bound{false}, done{false};
+    std::thread holder([&] {
+        group.local();
+        bound.store(true);
+        while (!done.load()) std::this_thread::yield();
+    });
+    while (!bound.load()) std::this_thread::yield();
+    EXPECT_THROW(group.local(), std::bad_alloc);
+    done.store(true);
+    holder.join();
+
+    EXPECT_EQ(&group.local(), first);
+}
+
+TEST(ArenaGroupTest, ThreadMayOutliveGroup) {
+    std::atomic<int> phase{0};
+    std::thread worker;
+    {
+        ArenaGroup group(1, 1024);
+        worker = std::thread([&] {
+            group.local();
+            phase.store(1);
+            while (phase.load() != 2) std::this_thread::yield();
+            // O grupo já foi destruído: a saída do thread não pode tocá-lo
+        });
+        while (phase.load() != 1) std::this_thread::yield();
+    }
+    phase.store(2);
+    worker.join();
+}
+
+struct GraphRoot {
+    float gain;
+    GainNode* node;
+    std::atomic<bool>* retired;
+    GraphRoot(float g, GainNode* n, std::atomic<bool>* r) : gain(g), node(n), retired(r) {}
+    ~GraphRoot() { retired->store(true); }
+};
+
+TEST(DoubleBufferedArenaTest, OldArenaResetOnlyAfterAck) {
+    DoubleBufferedArena<GraphRoot> graphs(4096);
+    EXPECT_EQ(graphs.acquire(), nullptr);
+
+    MemoryArena* build = graphs.beginBuild();
+    ASSERT_NE(build, nullptr);
+    std::atomic<bool> retiredA{false}, retiredB{false};
+    GraphRoot* a = build->emplace<GraphRoot>(0.5f, build->emplace<GainNode>(0.5f), &retiredA);
+    graphs.publish(a);
+
+    // Sem confirmação do áudio não dá para montar outro grafo
+    EXPECT_EQ(graphs.beginBuild(), nullptr);
+    EXPECT_EQ(graphs.acquire(), a);
+    EXPECT_FALSE(graphs.swapPending());
+
+    build = graphs.beginBuild();
+    ASSERT_NE(build, nullptr);
+    GraphRoot* b = build->emplace<GraphRoot>(0.25f, build->emplace<GainNode>(0.25f), &retiredB);
+    graphs.publish(b);
+    EXPECT_FALSE(retiredA.load()); // A ainda está em uso pelo áudio
+
+    EXPECT_EQ(graphs.acquire(), b);
+    ASSERT_NE(graphs.beginBuild(), nullptr); // Reseta a arena de A
+    EXPECT_TRUE(retiredA.load());
+    EXPECT_FALSE(retiredB.load());
+}
+
+TEST(DoubleBufferedArenaTest, AudioNeverSeesRetiredGraph) {
+    DoubleBufferedArena<GraphRoot> graphs(4096);
+    std::atomic<bool> done{false};
+    constexpr int kRebuilds = 2000;
+    std::atomic<bool> retired[kRebuilds + 1] = {};
+
+    std::thread control([&] {
+        for (int i = 1; i <= kRebuilds; ++i) {
+            MemoryArena* build;
+            while (!(build = graphs.beginBuild())) std::this_thread::yield();
+            float g = static_cast<float>(i);
+            graphs.publish(build->emplace<GraphRoot>(g, build->emplace<GainNode>(g), &retired[i]));
+        }
+        done.store(true);
+    });
+
+    std::vector<float> block(64, 1.0f);
+    while (!done.load() || graphs.acquire() == nullptr || graphs.acquire()->gain < kRebuilds) {
+        GraphRoot* root = graphs.acquire();
+        if (!root) { std::this_thread::yield(); continue; }
+        // Sem ASSERT aqui: sair do laço deixaria o controle esperando a
+        // confirmação e o thread ainda joinable
+        bool stale = retired[static_cast<int>(root->gain)].load();
+        EXPECT_FALSE(stale);
+        AudioBuffer buffer(block.data(), block.size());
+        if (!stale) root->node->process(buffer);
+        std::fill(block.begin(), block.end(), 1.0f);
+        std::this_thread::yield();
+    }
+    control.join();
+}
+
+TEST(ChainedArenaTest, GrowsByChunksAndReusesThemAfterReset) {
+    ChainedArena arena(64 * 1024);
+    EXPECT_EQ(arena.capacity(), 0u); // Nada mapeado até a primeira alocação
+
+    // Job maior que um chunk: a arena cresce em vez de lançar bad_alloc
+    std::vector<float*> blocks;
+    for (int i = 0; i < 64; ++i) {
+        float* block = static_cast<float*>(arena.allocate(4096 * sizeof(float), kArenaAlignment));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(block) % kArenaAlignment, 0u);
+        block[0] = static_cast<float>(i);
+        blocks.push_back(block);
+    }
+    EXPECT_GT(arena.chunks(), 1u);
+    EXPECT_GE(arena.used(), 64 * 4096 * sizeof(float));
+    for (int i = 0; i < 64; ++i) EXPECT_EQ(blocks[i][0], static_cast<float>(i));
+
+    // Pedido maior que o chunk ganha chunk próprio
+    void* big = arena.allocate(1024 * 1024);
+    EXPECT_TRUE(arena.owns(big));
+
+    size_t chunks = arena.chunks();
+    size_t capacity = arena.capacity();
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+
+    // O segundo job do mesmo tamanho não mapeia nada novo
+    for (int i = 0; i < 64; ++i) arena.allocate(4096 * sizeof(float), kArenaAlignment);
+    arena.allocate(1024 * 1024);
+    EXPECT_EQ(arena.chunks(), chunks);
+    EXPECT_EQ(arena.capacity(), capacity);
+    EXPECT_EQ(arena.stats().resets, 1u);
+}
+
+TEST(ChainedArenaTest, ReleaseUnusedReturnsExcessChunks) {
+    ChainedArena arena(64 * 1024);
+    for (int i = 0; i < 40; ++i) arena.allocate(16 * 1024);
+    size_t capacity = arena.capacity();
+    ASSERT_GE(arena.chunks(), 10u);
+
+    // Chunks em uso nunca são liberados
+    EXPECT_EQ(arena.releaseUnused(), 0u);
+
+    arena.reset();
+    size_t released = arena.releaseUnused(128 * 1024);
+    EXPECT_EQ(arena.chunks(), 2u);
+    EXPECT_EQ(released, capacity - arena.capacity());
+
+    EXPECT_GT(arena.releaseUnused(), 0u);
+    EXPECT_EQ(arena.chunks(), 0u);
+    EXPECT_EQ(arena.capacity(), 0u);
+
+    // Continua utilizável depois de liberar tudo
+    int* value = arena.emplace<int>(7);
+    EXPECT_EQ(*value, 7);
+}
+
+TEST(ChainedArenaTest, HugeRequestFailsInsteadOfWrapping) {
+    ChainedArena arena(4096);
+    arena.allocate(16);
+    size_t used = arena.used();
+    EXPECT_EQ(arena.tryAllocate(SIZE_MAX - 8, 1), nullptr);
+    EXPECT_EQ(arena.tryAllocate(SIZE_MAX, 4096), nullptr);
+    EXPECT_EQ(arena.used(), used);
+    EXPECT_EQ(arena.chunks(), 1u);
+    EXPECT_EQ(arena.stats().failedAllocations, 2u);
+}
+
+TEST(ChainedArenaTest, EmplaceRunsDestructorsOnReset) {
+    std::vector<int> order;
+    struct Tracked {
+        std::vector<int>* log;
+        int id;
+        ~Tracked() { log->push_back(id); }
+    };
+
+    ChainedArena arena(4096);
+    for (int i = 0; i < 300; ++i) arena.emplace<Tracked>(&order, i); // Atravessa vários chunks
+    arena.reset();
+
+    ASSERT_EQ(order.size(), 300u);
+    EXPECT_EQ(order.front(), 299);
+    EXPECT_EQ(order.back(), 0);
+}
+
+TEST(ChainedArenaTest, RewindAcrossChunksAndTags) {
+    int destroyed = 0;
+    struct Tracked {
+        int* counter;
+        ~Tracked() { ++*counter; }
+    };
+
+    ChainedArena arena(4096);
+    arena.allocate(100);
+    ArenaMarker marker = arena.mark();
+    size_t used = arena.used();
+    size_t chunks = arena.chunks();
+
+    uint8_t previous = arena.setTag(2);
+    for (int i = 0; i < 50; ++i) {
+        arena.emplace<Tracked>(&destroyed);
+        arena.allocate(200);
+    }
+    arena.setTag(previous);
+    EXPECT_GT(arena.chunks(), chunks);
+    EXPECT_EQ(arena.stats().tags[2].allocations, 150u); // Nó + objeto + bloco
+
+    arena.rewind(marker);
+    EXPECT_EQ(destroyed, 50);
+    EXPECT_EQ(arena.used(), used);
+
+    // Depois do rewind os chunks seguintes são reaproveitados, não remapeados
+    size_t mapped = arena.chunks();
+    for (int i = 0; i < 50; ++i) arena.allocate(200);
+    EXPECT_EQ(arena.chunks(), mapped);
+
+    // Marcador anterior ao reset() é ignorado
+    arena.reset();
+    arena.rewind(marker);
+    EXPECT_EQ(arena.used(), 0u);
+}
+
+TEST(ChainedArenaTest, RewindPastEarlierRewindKeepsOlderObjects) {
+    std::vector<int> destroyed;
+    ChainedArena arena(4096);
+    arena.emplace<IdTracked>(&destroyed, 1);
+
+    ArenaMarker m0 = arena.mark();
+    arena.emplace<IdTracked>(&destroyed, 2);
+    ArenaMarker m1 = arena.mark();
+    arena.rewind(m0);
+    EXPECT_EQ(destroyed, std::vector<int>({2}));
+
+    // Passa de m1: 3 fica antes dele, 4 depois, em outro chunk
+    arena.emplace<IdTracked>(&destroyed, 3);
+    arena.allocate(8192);
+    arena.emplace<IdTracked>(&destroyed, 4);
+    ASSERT_GT(arena.chunks(), 1u);
+    arena.rewind(m1);
+
+    EXPECT_EQ(destroyed, std::vector<int>({2, 4}));
+    EXPECT_EQ(arena.used(), m1.offset);
+    arena.reset();
+    EXPECT_EQ(destroyed, std::vector<int>({2, 4, 3, 1}));
+}
+
+// Inicialização constante: o compilador rejeitaria este constinit se a
+// StaticArena dependesse de qualquer inicialização dinâmica
+constinit StaticArenaStorage<64 * 1024> staticTestStorage;
+constinit StaticArena<staticTestStorage> staticTestArena;
+
+TEST(StaticArenaTest, ConstinitArenaAllocatesLikeMemoryArena) {
+    staticTestArena.reset();
+    EXPECT_EQ(staticTestArena.capacity(), 64u * 1024);
+    EXPECT_EQ(staticTestArena.used(), 0u);
+
+    void* block = staticTestArena.allocate(1000, kArenaAlignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % kArenaAlignment, 0u);
+    EXPECT_TRUE(staticTestArena.owns(block));
+
+    GainNode* gain = staticTestArena.emplace<GainNode>(0.5f);
+    std::vector<float> data = {1.0f, 2.0f};
+    AudioBuffer buffer(data.data(), data.size());
+    gain->process(buffer);
+    EXPECT_FLOAT_EQ(data[1], 1.0f);
+
+    EXPECT_EQ(staticTestArena.tryAllocate(128 * 1024), nullptr);
+    EXPECT_THROW(staticTestArena.allocate(128 * 1024), std::bad_alloc);
+    EXPECT_EQ(staticTestArena.stats().failedAllocations, 2u);
+}
+
+constinit StaticArenaStorage<4096> staticScratchStorage;
+constinit StaticArenaStorage<4096> staticPoolStorage;
+constinit StaticArena<staticScratchStorage> staticScratchArena;
+constinit StaticArena<staticPoolStorage> staticPoolArena;
+
+TEST(StaticArenaTest, SameSizeArenasNeverShareStorage) {
+    static StaticArenaStorage<4096> firstStorage;
+    static StaticArenaStorage<4096> secondStorage;
+    static StaticArena<firstStorage> first;
+    static StaticArena<secondStorage> second;
+
+    void* a = first.allocate(64);
+    void* b = second.allocate(64);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(first.owns(a));
+    EXPECT_FALSE(first.owns(b));
+    EXPECT_FALSE(second.owns(a));
+}
+
+TEST(StaticArenaTest, WorksWithEveryArenaConsumer) {
+    staticScratchArena.reset();
+    staticPoolArena.reset();
+    EXPECT_FALSE(staticScratchArena.owns(staticPoolArena.allocate(16)));
+
+    int destroyed = 0;
+    struct Tracked {
+        int* counter;
+        ~Tracked() { ++*counter; }
+    };
+
+    staticScratchArena.emplace<Tracked>(&destroyed);
+    {
+        ArenaScope scope(staticScratchArena);
+        ArenaTagScope tag(staticScratchArena, 3);
+        staticScratchArena.emplace<Tracked>(&destroyed);
+        staticScratchArena.emplace<Tracked>(&destroyed);
+        EXPECT_EQ(staticScratchArena.stats().tags[3].allocations, 4u); // Nó + objeto, duas vezes
+    }
+    EXPECT_EQ(destroyed, 2);
+    staticScratchArena.reset();
+    EXPECT_EQ(destroyed, 3);
+
+    BlockPool pool(staticPoolArena, 256, 4);
+    void* block = pool.allocate();
+    EXPECT_TRUE(staticPoolArena.owns(block));
+    pool.deallocate(block);
+
+    ArenaResource resource(staticScratchArena);
+    std::pmr::vector<int> values({1, 2, 3}, &resource);
+    EXPECT_TRUE(staticScratchArena.owns(values.data()));
+
+    ArenaRingBuffer<int> ring(staticScratchArena, 8);
+    EXPECT_TRUE(ring.push(42));
+}
+
 // ============================================================================
 // TESTES: LOCK-FREE RING BUFFER (Concurrency)
 // ============================================================================
@@ -113,6 +838,548 @@ TEST(RingBufferTest, FIFOOrder) {
     }
 }
 
+TEST(RingBufferTest, BulkPushPopWrapsAround) {
+    LockFreeRingBuffer<int, 8> rb;
+    EXPECT_EQ(rb.write_available(), 7);
+
+    // Avança os índices para forçar a escrita em dois segmentos
+    std::vector<int> warmup = {0, 0, 0, 0, 0};
+    EXPECT_EQ(rb.push_n(warmup), 5);
+    EXPECT_EQ(rb.pop_n(warmup), 5);
+
+    std::vector<int> in = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(rb.push_n(in), 6);
+    EXPECT_EQ(rb.read_available(), 6);
+    EXPECT_EQ(rb.write_available(), 1);
+
+    std::vector<int> out(6, 0);
+    EXPECT_EQ(rb.pop_n(out), 6);
+    EXPECT_EQ(out, in);
+    EXPECT_TRUE(rb.isEmpty());
+}
+
+TEST(RingBufferTest, BulkPushIsPartialWhenFull) {
+    LockFreeRingBuffer<int, 4> rb;
+    std::vector<int> in = {1, 2, 3, 4, 5};
+    EXPECT_EQ(rb.push_n(in), 3);
+    EXPECT_EQ(rb.push_n(in), 0);
+
+    std::vector<int> out(8, 0);
+    EXPECT_EQ(rb.pop_n(out), 3);
+    EXPECT_EQ(out[2], 3);
+}
+
+TEST(RingBufferTest, ConcurrentProducerConsumer) {
+    // Produtor e consumidor em threads distintas; exercita o recarregamento
+    // dos índices em cache quando o buffer parece cheio ou vazio
+    LockFreeRingBuffer<int, 16> rb;
+    constexpr int kItems = 100000;
+
+    std::thread producer([&] {
+        for (int i = 0; i < kItems; ++i) {
+            while (!rb.push(i)) std::this_thread::yield();
+        }
+    });
+
+    // EXPECT: numa falha continua consumindo, para o produtor terminar e ser
+    // unido (ASSERT sairia com o thread ainda joinable -> std::terminate)
+    int val = -1;
+    for (int i = 0; i < kItems; ++i) {
+        while (!rb.pop(val)) std::this_thread::yield();
+        EXPECT_EQ(val, i);
+    }
+    producer.join();
+    EXPECT_TRUE(rb.isEmpty());
+}
+
+TEST(RingBufferTest, TelemetryTracksFillAndXruns) {
+    LockFreeRingBuffer<int, 8, kRingTelemetry> rb;
+    int val;
+
+    EXPECT_FALSE(rb.pop(val)); // underrun
+    std::vector<int> in = {1, 2, 3, 4, 5};
+    rb.push_n(in);
+    rb.push_n(in);             // só cabem 2: overrun
+    EXPECT_TRUE(rb.pop(val));
+    EXPECT_TRUE(rb.pop(val));
+
+    RingStats s = rb.takeStats();
+    EXPECT_EQ(s.maxFill, 7);
+    EXPECT_EQ(s.minFill, 5);
+    EXPECT_EQ(s.overruns, 1);
+    EXPECT_EQ(s.underruns, 1);
+
+    // Após o reset, só contam eventos novos
+    s = rb.stats();
+    EXPECT_EQ(s.overruns, 0);
+    EXPECT_EQ(s.maxFill, 0);
+}
+
+TEST(RingBufferTest, BlockingWaitOnNonRealtimeSide) {
+    // Produtor bloqueante (decoder) alimentando um consumidor que só faz pop()
+    LockFreeRingBuffer<int, 4, kRingBlocking> toAudio;
+    // Consumidor bloqueante (gravador) recebendo de um produtor que só faz push()
+    PowerOfTwoRingBuffer<int, 4, kRingBlocking> fromAudio;
+    constexpr int kItems = 20000;
+
+    std::thread decoder([&] {
+        for (int i = 0; i < kItems; ++i) toAudio.push_wait(i);
+    });
+    std::thread recorder([&] {
+        int val;
+        for (int i = 0; i < kItems; ++i) {
+            fromAudio.pop_wait(val);
+            EXPECT_EQ(val, i);
+        }
+    });
+
+    // EXPECT e não ASSERT: uma falha deve continuar drenando até o fim, senão
+    // os threads ficam presos no push/pop e o teste trava em vez de falhar
+    int val;
+    for (int i = 0; i < kItems; ++i) {
+        while (!toAudio.pop(val)) std::this_thread::yield();
+        EXPECT_EQ(val, i);
+        while (!fromAudio.push(val)) std::this_thread::yield();
+    }
+
+    decoder.join();
+    recorder.join();
+    EXPECT_TRUE(toAudio.isEmpty());
+    EXPECT_TRUE(fromAudio.isEmpty());
+}
+
+TEST(PowerOfTwoRingBufferTest, UsesFullCapacity) {
+    PowerOfTwoRingBuffer<int, 4> rb;
+    EXPECT_EQ(rb.write_available(), 4);
+
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(rb.push(i));
+    EXPECT_FALSE(rb.push(4));
+    EXPECT_EQ(rb.read_available(), 4);
+
+    int val;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(rb.pop(val));
+        EXPECT_EQ(val, i);
+    }
+    EXPECT_FALSE(rb.pop(val));
+}
+
+TEST(PowerOfTwoRingBufferTest, BulkWrapAround) {
+    PowerOfTwoRingBuffer<int, 8> rb;
+    std::vector<int> scratch(8, 0);
+
+    // Várias voltas completas para exercitar a máscara sobre contadores livres
+    for (int round = 0; round < 5; ++round) {
+        std::vector<int> in = {round, round + 1, round + 2, round + 3, round + 4};
+        EXPECT_EQ(rb.push_n(in), 5);
+        EXPECT_EQ(rb.pop_n(std::span<int>(scratch).first(5)), 5);
+        EXPECT_TRUE(std::equal(in.begin(), in.end(), scratch.begin()));
+    }
+    EXPECT_TRUE(rb.isEmpty());
+}
+
+TEST(RingBufferTest, ReserveCommitPeekRelease) {
+    LockFreeRingBuffer<float, 8> rb;
+
+    // Avança os índices para que a reserva cruze o fim do array
+    std::vector<float> warmup(6, 0.0f);
+    rb.push_n(warmup);
+    rb.pop_n(warmup);
+
+    RingRegion<float> w = rb.reserve(5);
+    ASSERT_EQ(w.size(), 5);
+    EXPECT_EQ(w.first.size(), 2);
+    EXPECT_EQ(w.second.size(), 3);
+
+    // Nada visível antes do commit
+    EXPECT_TRUE(rb.peek(5).empty());
+
+    float v = 1.0f;
+    for (float& s : w.first) s = v++;
+    for (float& s : w.second) s = v++;
+    rb.commit(w.size());
+
+    // Processa in-place e devolve ao produtor
+    RingRegion<float> r = rb.peek(8);
+    ASSERT_EQ(r.size(), 5);
+    for (float& s : r.first) s *= 2.0f;
+    for (float& s : r.second) s *= 2.0f;
+    EXPECT_FLOAT_EQ(r.first[0], 2.0f);
+    EXPECT_FLOAT_EQ(r.second[2], 10.0f);
+    rb.release(r.size());
+
+    EXPECT_TRUE(rb.isEmpty());
+    EXPECT_EQ(rb.write_available(), 7);
+}
+
+TEST(MPSCQueueTest, FIFOAndFullCapacity) {
+    MPSCQueue<int, 4> q;
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(q.push(i));
+    EXPECT_FALSE(q.push(4));
+
+    int val;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(q.pop(val));
+        EXPECT_EQ(val, i);
+    }
+    EXPECT_FALSE(q.pop(val));
+    EXPECT_TRUE(q.isEmpty());
+}
+
+TEST(MPSCQueueTest, MultipleProducersPreservePerProducerOrder) {
+    MPSCQueue<int, 64> q;
+    constexpr int kProducers = 4;
+    constexpr int kItems = 20000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kItems; ++i) {
+                while (!q.push(p * kItems + i)) std::this_thread::yield();
+            }
+        });
+    }
+
+    // Cada produtor deve chegar em ordem, sem perdas nem duplicatas. EXPECT:
+    // uma falha continua drenando até o total, senão os produtores ficam
+    // joinable e o teste termina em std::terminate
+    std::vector<int> next(kProducers, 0);
+    int val;
+    for (int received = 0; received < kProducers * kItems;) {
+        if (!q.pop(val)) { std::this_thread::yield(); continue; }
+        int p = val / kItems;
+        EXPECT_EQ(val % kItems, next[p]);
+        next[p] = val % kItems + 1;
+        ++received;
+    }
+    for (auto& t : producers) t.join();
+    EXPECT_TRUE(q.isEmpty());
+}
+
+TEST(BroadcastRingTest, EveryReaderSeesEveryItem) {
+    BroadcastRingBuffer<int, 8, 4> rb;
+    int out = rb.registerReader();
+    int rec = rb.registerReader();
+    ASSERT_NE(out, rb.kInvalidReader);
+    ASSERT_NE(rec, rb.kInvalidReader);
+
+    for (int i = 0; i < 5; ++i) EXPECT_TRUE(rb.push(i));
+
+    int val;
+    for (int reader : {out, rec}) {
+        EXPECT_EQ(rb.read_available(reader), 5);
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_TRUE(rb.pop(reader, val));
+            EXPECT_EQ(val, i);
+        }
+        EXPECT_FALSE(rb.pop(reader, val));
+    }
+}
+
+TEST(BroadcastRingTest, SlowestCriticalReaderBlocksWriter) {
+    BroadcastRingBuffer<int, 4, 2> rb;
+    int fast = rb.registerReader();
+    int slow = rb.registerReader();
+
+    int val;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(rb.push(i));
+        EXPECT_TRUE(rb.pop(fast, val));
+    }
+    EXPECT_FALSE(rb.push(4)); // Leitor lento ainda segura o slot mais antigo
+
+    EXPECT_TRUE(rb.pop(slow, val));
+    EXPECT_TRUE(rb.push(4));
+}
+
+TEST(BroadcastRingTest, NonCriticalReaderIsOverwritten) {
+    BroadcastRingBuffer<int, 4, 2> rb;
+    int meter = rb.registerReader(false);
+
+    for (int i = 0; i < 10; ++i) EXPECT_TRUE(rb.push(i));
+
+    // O medidor perde os itens antigos e retoma pelos mais recentes
+    int val;
+    ASSERT_TRUE(rb.pop(meter, val));
+    EXPECT_EQ(val, 7);
+    EXPECT_EQ(rb.overruns(meter), 7);
+
+    rb.unregisterReader(meter);
+    EXPECT_EQ(rb.registerReader(), meter);
+}
+
+TEST(BroadcastRingTest, ConcurrentReadersWithRegistrationChurn) {
+    BroadcastRingBuffer<int, 16, 8> rb;
+    constexpr int kItems = 200000;
+    int out = rb.registerReader();
+    int rec = rb.registerReader();
+    int meter = rb.registerReader(false);
+    std::atomic<bool> done{false};
+
+    // Leitores críticos: todos os itens, em ordem
+    auto critical = [&](int reader) {
+        int val;
+        for (int expected = 0; expected < kItems;) {
+            if (!rb.pop(reader, val)) { std::this_thread::yield(); continue; }
+            EXPECT_EQ(val, expected);
+            expected = val + 1;
+        }
+    };
+    std::thread output(critical, out);
+    std::thread recorder(critical, rec);
+
+    // Medidor atrasado: só valores crescentes, e cada valor lido é a soma
+    // dos itens lidos com os perdidos
+    std::thread lagging([&] {
+        int val;
+        uint64_t popped = 0;
+        int last = -1;
+        while (last != kItems - 1) {
+            if (!rb.pop(meter, val)) { std::this_thread::yield(); continue; }
+            EXPECT_GT(val, last);
+            EXPECT_EQ(static_cast<uint64_t>(val), popped + rb.overruns(meter));
+            last = val;
+            ++popped;
+            if (popped % 64 == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    });
+
+    // Leitores críticos entrando e saindo enquanto o escritor varre os cursores
+    std::thread churn([&] {
+        int val;
+        while (!done.load(std::memory_order_acquire)) {
+            int reader = rb.registerReader();
+            if (reader == rb.kInvalidReader) continue;
+            int previous = -1;
+            for (int n = 0; n < 100 && !done.load(std::memory_order_acquire);) {
+                if (!rb.pop(reader, val)) { std::this_thread::yield(); continue; }
+                if (previous >= 0) EXPECT_EQ(val, previous + 1);
+                previous = val;
+                ++n;
+            }
+            rb.unregisterReader(reader);
+        }
+    });
+
+    for (int i = 0; i < kItems; ++i) {
+        while (!rb.push(i)) std::this_thread::yield();
+    }
+    output.join();
+    recorder.join();
+    lagging.join();
+    done.store(true, std::memory_order_release);
+    churn.join();
+    EXPECT_GT(rb.overruns(meter), 0u); // O medidor de fato ficou para trás
+}
+
+#ifdef __linux__
+TEST(MirroredRingBufferTest, WrappedRegionIsContiguous) {
+    MirroredRingBuffer<float> rb(1000);
+    const size_t cap = rb.capacity();
+    ASSERT_GE(cap, 1000);
+
+    // Posiciona os contadores perto do fim do array
+    std::vector<float> warmup(cap - 3, 0.0f);
+    rb.push_n(warmup);
+    rb.pop_n(warmup);
+
+    std::span<float> w = rb.reserve(16);
+    ASSERT_EQ(w.size(), 16);
+    for (size_t i = 0; i < w.size(); ++i) w[i] = 1.0f;
+    rb.commit(w.size());
+
+    // O GainNode processa a região inteira num único laço, apesar da volta
+    std::span<float> r = rb.peek(16);
+    ASSERT_EQ(r.size(), 16);
+    AudioBuffer block(r.data(), r.size());
+    GainNode(0.5f).process(block);
+    for (float s : r) EXPECT_FLOAT_EQ(s, 0.5f);
+    rb.release(r.size());
+
+    EXPECT_TRUE(rb.isEmpty());
+    EXPECT_EQ(rb.write_available(), cap);
+}
+#endif
+
+struct ParamChange { uint32_t nodeId; float value; };
+struct TransportCommand { bool playing; };
+struct GraphEdit { uint32_t from, to; uint64_t flags[6]; };
+
+TEST(MessageRingTest, DispatchesByTypeInOrder) {
+    MessageRing<256, ParamChange, TransportCommand, GraphEdit> ring;
+
+    EXPECT_TRUE(ring.send(ParamChange{3, 0.5f}));
+    EXPECT_TRUE(ring.send(TransportCommand{true}));
+    EXPECT_TRUE(ring.send(GraphEdit{1, 2, {}}));
+
+    std::vector<int> order;
+    float value = 0.0f;
+    size_t n = ring.drain(Overloaded{
+        [&](const ParamChange& m) { order.push_back(0); value = m.value; },
+        [&](const TransportCommand& m) { order.push_back(1); EXPECT_TRUE(m.playing); },
+        [&](const GraphEdit& m) { order.push_back(2); EXPECT_EQ(m.to, 2u); },
+    });
+
+    EXPECT_EQ(n, 3);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_FLOAT_EQ(value, 0.5f);
+    EXPECT_TRUE(ring.isEmpty());
+}
+
+TEST(MessageRingTest, WrapsWithPaddingAndRejectsWhenFull) {
+    // GraphEdit ocupa 80 bytes, ParamChange 32: força padding ao dar a volta
+    MessageRing<128, ParamChange, GraphEdit> ring;
+    auto ignore = Overloaded{[](const ParamChange&) {}, [](const GraphEdit&) {}};
+
+    EXPECT_TRUE(ring.send(GraphEdit{}));
+    EXPECT_TRUE(ring.send(ParamChange{}));
+    EXPECT_FALSE(ring.send(ParamChange{})); // Restam só 16 bytes
+    EXPECT_EQ(ring.drain(ignore), 2);
+
+    // Posição 112: GraphEdit não cabe nos 16 bytes finais e recomeça em 0
+    EXPECT_TRUE(ring.send(GraphEdit{7, 8, {}}));
+    uint32_t to = 0;
+    EXPECT_EQ(ring.drain(Overloaded{[](const ParamChange&) {},
+                                    [&](const GraphEdit& m) { to = m.to; }}), 1);
+    EXPECT_EQ(to, 8u);
+}
+
+TEST(TripleBufferTest, ReaderSeesLatestSnapshot) {
+    TripleBuffer<int> tb;
+    EXPECT_FALSE(tb.update());
+
+    // Escritor publica várias vezes; o leitor só vê a última
+    tb.write(1);
+    tb.write(2);
+    tb.writeBuffer() = 3;
+    tb.publish();
+
+    EXPECT_TRUE(tb.update());
+    EXPECT_EQ(tb.read(), 3);
+    EXPECT_FALSE(tb.update());
+    EXPECT_EQ(tb.read(), 3);
+}
+
+TEST(TripleBufferTest, ConcurrentSnapshotsAreNeverTorn) {
+    struct Meter { int peak; int rms; };
+    TripleBuffer<Meter> tb;
+    constexpr int kFrames = 100000;
+
+    std::thread audio([&] {
+        for (int i = 1; i <= kFrames; ++i) {
+            Meter& m = tb.writeBuffer();
+            m.peak = i;
+            m.rms = -i;
+            tb.publish();
+        }
+    });
+
+    // EXPECT: numa falha o laço segue até kFrames e o thread de áudio é unido
+    int last = 0;
+    while (last < kFrames) {
+        if (!tb.update()) { std::this_thread::yield(); continue; }
+        const Meter& m = tb.read();
+        EXPECT_EQ(m.rms, -m.peak);
+        EXPECT_GT(m.peak, last); // Snapshots só avançam
+        last = std::max(last, m.peak);
+    }
+    audio.join();
+}
+
+TEST(DeferredReclaimTest, DestroysOnHousekeepingThreadOnly) {
+    struct Tracked {
+        std::atomic<int>* destroyed;
+        explicit Tracked(std::atomic<int>* d) : destroyed(d) {}
+        ~Tracked() { destroyed->fetch_add(1); }
+    };
+
+    std::atomic<int> destroyed{0};
+    DeferredReclaimQueue<4> garbage;
+
+    auto owned = std::make_unique<Tracked>(&destroyed);
+    EXPECT_TRUE(garbage.retire(owned));
+    EXPECT_EQ(owned, nullptr);
+    EXPECT_TRUE(garbage.retire(new Tracked(&destroyed)));
+
+    // Nada é destruído no momento do retire
+    EXPECT_EQ(destroyed.load(), 0);
+    EXPECT_EQ(garbage.pending(), 2);
+
+    std::thread housekeeping([&] { EXPECT_EQ(garbage.collect(), 2); });
+    housekeeping.join();
+    EXPECT_EQ(destroyed.load(), 2);
+}
+
+TEST(DeferredReclaimTest, FullQueueKeepsOwnership) {
+    DeferredReclaimQueue<2> garbage;
+    int* a = new int(1);
+    int* b = new int(2);
+    auto c = std::make_unique<int>(3);
+
+    EXPECT_TRUE(garbage.retire(a));
+    EXPECT_TRUE(garbage.retire(b));
+    EXPECT_FALSE(garbage.retire(c));
+    EXPECT_NE(c, nullptr); // Ainda pertence ao chamador
+}
+
+TEST(ArenaRingBufferTest, RuntimeCapacityFromArena) {
+    MemoryArena arena(4096);
+    ArenaRingBuffer<int> rb(arena, 100);
+    EXPECT_EQ(rb.capacity(), 128);
+    EXPECT_GE(arena.used(), 128 * sizeof(int));
+
+    for (int i = 0; i < 128; ++i) EXPECT_TRUE(rb.push(i));
+    EXPECT_FALSE(rb.push(128));
+
+    int val;
+    for (int i = 0; i < 128; ++i) {
+        ASSERT_TRUE(rb.pop(val));
+        EXPECT_EQ(val, i);
+    }
+    EXPECT_TRUE(rb.isEmpty());
+}
+
+TEST(ArenaRingBufferTest, MoveOnlyElementsAreDestroyed) {
+    MemoryArena arena(1024);
+    std::weak_ptr<int> watch;
+    {
+        ArenaRingBuffer<std::unique_ptr<int>> rb(arena, 4);
+        EXPECT_TRUE(rb.push(std::make_unique<int>(7)));
+
+        auto shared = std::make_shared<int>(9);
+        watch = shared;
+        ArenaRingBuffer<std::shared_ptr<int>> pending(arena, 4);
+        EXPECT_TRUE(pending.emplace(std::move(shared)));
+
+        std::unique_ptr<int> out;
+        ASSERT_TRUE(rb.pop(out));
+        EXPECT_EQ(*out, 7);
+        EXPECT_FALSE(watch.expired()); // Ainda vivo dentro do ring
+    }
+    // O destrutor do ring destrói os elementos que não foram consumidos
+    EXPECT_TRUE(watch.expired());
+}
+
+TEST(ArenaRingBufferTest, ConsumeWorksWithoutDefaultConstructor) {
+    struct Command {
+        int id;
+        std::unique_ptr<int> payload;
+        Command(int i, int value) : id(i), payload(std::make_unique<int>(value)) {}
+    };
+    static_assert(!std::is_default_constructible_v<Command>);
+
+    MemoryArena arena(1024);
+    ArenaRingBuffer<Command> rb(arena, 4);
+    EXPECT_TRUE(rb.emplace(1, 10));
+    EXPECT_TRUE(rb.emplace(2, 20));
+
+    int sum = 0;
+    while (rb.consume([&](Command&& cmd) { sum += cmd.id * *cmd.payload; })) {}
+    EXPECT_EQ(sum, 50);
+    EXPECT_TRUE(rb.isEmpty());
+    EXPECT_FALSE(rb.consume([](Command&&) {}));
+}
+
 // ============================================================================
 // TESTES: AUDIO NODES (DSP Logic)
 // ============================================================================
@@ -184,6 +1451,91 @@ TEST(FadeNodeTest, LinearFadeOut) {
     EXPECT_NEAR(data[4], 0.0f, 0.0001f);
 }
 
+// ============================================================================
+// TESTES: ALOCAÇÃO NO THREAD DE ÁUDIO (build com MIXER_RT_ALLOC_GUARD)
+// ============================================================================
+
+// Destino volátil para que o compilador não elimine o par new/delete
+static void* volatile allocationSink;
+
+TEST(RtAllocGuardTest, ProcessedBlocksDoNotAllocate) {
+    constexpr size_t kBlock = 256;
+    MemoryArena arena(64 * 1024);
+    BlockPool pool(arena, kBlock * sizeof(float), 4);
+    PowerOfTwoRingBuffer<float, 1024> ring;
+    MessageRing<1024, float, int> control;
+    std::vector<float> in1(kBlock, 0.5f), in2(kBlock, 0.25f), out(kBlock);
+    GainNode gain(0.8f);
+    FadeNode fade(1000.0f, true);
+
+    RtAllocStats before = rtAllocStats();
+    for (int block = 0; block < 100; ++block) {
+        ASSERT_TRUE(control.send(0.8f));
+
+        RtScope rt;
+        control.drain(Overloaded{[](float) {}, [](int) {}});
+
+        ArenaScope scratch(arena);
+        float* temp = static_cast<float*>(arena.allocate(kBlock * sizeof(float)));
+        float* pooled = static_cast<float*>(pool.allocate());
+        ASSERT_NE(pooled, nullptr);
+
+        AudioBuffer b1(in1.data(), kBlock), b2(in2.data(), kBlock), bOut(out.data(), kBlock);
+        gain.process(b1);
+        fade.process(b2);
+        MixerNode::mix(b1, b2, bOut);
+
+        std::copy(out.begin(), out.end(), temp);
+        std::copy(temp, temp + kBlock, pooled);
+        ring.push_n(std::span<const float>(pooled, kBlock));
+        ring.pop_n(std::span<float>(temp, kBlock));
+        pool.deallocate(pooled);
+    }
+    RtAllocStats after = rtAllocStats();
+
+    EXPECT_EQ(after.allocations - before.allocations, 0u);
+    EXPECT_EQ(after.deallocations - before.deallocations, 0u);
+}
+
+TEST(RtAllocGuardTest, CountsAllocationsInsideScopeOnly) {
+    if (!kRtAllocGuard) GTEST_SKIP() << "Build sem MIXER_RT_ALLOC_GUARD";
+
+    // Aloca de propósito dentro do RtScope: não pode abortar quando a suíte
+    // roda com MIXER_RT_ALLOC_STRICT=1
+    RtAllocMode previous = setRtAllocMode(RtAllocMode::Count);
+
+    RtAllocStats before = rtAllocStats();
+    allocationSink = new int(1);
+    delete static_cast<int*>(allocationSink);
+    EXPECT_EQ(rtAllocStats().allocations, before.allocations);
+
+    {
+        RtScope rt;
+        EXPECT_TRUE(inRtScope());
+        allocationSink = std::malloc(64);
+        std::free(allocationSink);
+        allocationSink = new float[16];
+        delete[] static_cast<float*>(allocationSink);
+    }
+    EXPECT_FALSE(inRtScope());
+
+    RtAllocStats after = rtAllocStats();
+    EXPECT_EQ(after.allocations - before.allocations, 2u);
+    EXPECT_EQ(after.deallocations - before.deallocations, 2u);
+
+    setRtAllocMode(previous);
+}
+
+TEST(RtAllocGuardDeathTest, StrictModeAbortsWithBacktrace) {
+    if (!kRtAllocGuard) GTEST_SKIP() << "Build sem MIXER_RT_ALLOC_GUARD";
+
+    EXPECT_DEATH({
+        setRtAllocMode(RtAllocMode::Abort);
+        RtScope rt;
+        allocationSink = std::malloc(32);
+    }, "malloc\\(32\\) dentro de RtScope");
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();